@@ -9,6 +9,9 @@ This script converts the gfaser files to hepmc, it takes three arguments:
 1) input - the input gfaser file to convert
 2) -n (--nevents) - the number of events to write per file
 3) -o (--output) - a directory to write the output to 
+
+Note: pinpoint can read gfaser files directly with `/gen/select gfaser`
+and `/gen/gfaser/input <file>`, without converting them first
 """
 
 import uproot
@@ -1,7 +1,10 @@
 #include <G4RunManager.hh>
 #include <G4UImanager.hh>
+#include <G4StateManager.hh>
 
+#ifdef PINPOINT_WITH_VIS
 #include <G4VisExecutive.hh>
+#endif
 
 #include <G4UIExecutive.hh>
 
@@ -11,37 +14,202 @@
 #include "AnalysisManager.hh"
 // #include "PhysicsList.hh"
 #include "FTFP_BERT.hh"
+#include "StartupTimer.hh"
+#include "PhysicsTableCache.hh"
+
+#include "TROOT.h"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+// Settings given on the command line
+struct CommandLine {
+  G4String macro;
+  G4bool vis = false;
+  G4int events = -1;       // -1: the macro starts the run(s)
+  G4int threads = 1;
+  G4String output;
+  G4String input;
+  G4String generator;
+  G4String seed;
+  G4String firstEvent;
+  G4String shard;          // "i/N"
+  std::vector<G4String> commands; // --set pass-through
+};
+
+static void PrintUsage()
+{
+  G4cout << "Usage: pinpoint [macro [vis]] [options]\n"
+         << "  --macro <file>        macro executed after the options below are applied\n"
+         << "  --events <n>          run n events after the macro (/run/beamOn n)\n"
+         << "  --threads <n>         threads used by ROOT to compress the output (events are simulated sequentially)\n"
+         << "  --output <file>       output file (/out/fileName)\n"
+         << "  --generator <name>    gun, genie, gfaser or hepmc (/gen/select)\n"
+         << "  --input <file>        input file of the genie, gfaser or hepmc generator\n"
+         << "  --seed <n>            master seed of the run (/random/masterSeed)\n"
+         << "  --first-event <n>     first input entry read by the genie, gfaser or hepmc generator\n"
+         << "  --shard <i>/<N>       read only the i-th of N contiguous blocks of the input\n"
+         << "  --set <cmd> [args]    apply any UI command, e.g. --set /gen/hepmc/prefetch 8\n"
+         << "  --vis                 start an interactive session after the macro\n"
+         << "Without arguments an interactive session with macros/vis.mac is started." << G4endl;
+}
+
+// returns false if the command line cannot be parsed
+static G4bool ParseCommandLine(int argc, char** argv, CommandLine& cl)
+{
+  std::vector<std::string> args(argv + 1, argv + argc);
+  for (std::size_t i = 0; i < args.size(); ++i) {
+    const std::string& arg = args[i];
+    auto value = [&](std::string& out) {
+      if (i + 1 >= args.size()) {
+        G4cerr << "Missing value for option " << arg << G4endl;
+        return false;
+      }
+      out = args[++i];
+      return true;
+    };
+    std::string val;
+
+    if (arg == "--help" || arg == "-h") return false;
+    else if (arg == "--vis") cl.vis = true;
+    else if (arg == "--macro") { if (!value(val)) return false; cl.macro = val; }
+    else if (arg == "--events") { if (!value(val)) return false; cl.events = std::atoi(val.c_str()); }
+    else if (arg == "--threads") { if (!value(val)) return false; cl.threads = std::atoi(val.c_str()); }
+    else if (arg == "--output") { if (!value(val)) return false; cl.output = val; }
+    else if (arg == "--input") { if (!value(val)) return false; cl.input = val; }
+    else if (arg == "--generator") { if (!value(val)) return false; cl.generator = val; }
+    else if (arg == "--seed") { if (!value(val)) return false; cl.seed = val; }
+    else if (arg == "--first-event") { if (!value(val)) return false; cl.firstEvent = val; }
+    else if (arg == "--shard") { if (!value(val)) return false; cl.shard = val; }
+    else if (arg == "--set") {
+      // the command and all its parameters up to the next option
+      G4String command;
+      while (i + 1 < args.size() && args[i+1].rfind("--", 0) != 0) command += (command.empty() ? "" : " ") + args[++i];
+      if (command.empty()) {
+        G4cerr << "Missing command for option --set" << G4endl;
+        return false;
+      }
+      cl.commands.push_back(command);
+    }
+    else if (arg.rfind("--", 0) == 0) {
+      G4cerr << "Unknown option " << arg << G4endl;
+      return false;
+    }
+    // positional arguments as before: macro [vis]
+    else if (cl.macro.empty()) cl.macro = arg;
+    else if (arg == "vis") cl.vis = true;
+    else {
+      G4cerr << "Please specify the second argument as vis to visualize the event" << G4endl;
+      return false;
+    }
+  }
+
+  if (cl.events > 0 || !cl.macro.empty() || cl.vis) return true;
+  G4cerr << "Nothing to do: give a macro and/or --events" << G4endl;
+  return false;
+}
+
+// UI commands equivalent to the command line options, applied before the macro
+static std::vector<G4String> OptionCommands(const CommandLine& cl)
+{
+  std::vector<G4String> commands;
+  if (!cl.seed.empty()) commands.push_back("/random/masterSeed " + cl.seed);
+  if (!cl.output.empty()) commands.push_back("/out/fileName " + cl.output);
+  if (!cl.generator.empty()) commands.push_back("/gen/select " + cl.generator);
+
+  G4bool needsGenerator = !cl.input.empty() || !cl.firstEvent.empty() || !cl.shard.empty();
+  if (needsGenerator && cl.generator != "genie" && cl.generator != "gfaser" && cl.generator != "hepmc") {
+    G4cerr << "--input, --first-event and --shard need --generator genie, gfaser or hepmc" << G4endl;
+    std::exit(EXIT_FAILURE);
+  }
+
+  if (!cl.input.empty()) {
+    if (cl.generator == "genie") commands.push_back("/gen/genie/genieInput " + cl.input);
+    else if (cl.generator == "gfaser") commands.push_back("/gen/gfaser/input " + cl.input);
+    else commands.push_back("/gen/hepmc/hepmcInput " + cl.input);
+  }
+  if (!cl.firstEvent.empty()) {
+    if (cl.generator == "hepmc") commands.push_back("/gen/hepmc/firstEvent " + cl.firstEvent);
+    else commands.push_back("/gen/" + cl.generator + "/range " + cl.firstEvent + " -1");
+  }
+  if (!cl.shard.empty()) {
+    std::size_t slash = cl.shard.find('/');
+    if (slash == std::string::npos) {
+      G4cerr << "--shard expects i/N, got " << cl.shard << G4endl;
+      std::exit(EXIT_FAILURE);
+    }
+    commands.push_back("/gen/" + cl.generator + "/shard " + cl.shard.substr(0, slash) + " " + cl.shard.substr(slash + 1));
+  }
+
+  for (const auto& command : cl.commands) commands.push_back(command);
+  return commands;
+}
 
 /* Main function that enables to:
- * - run macros
+ * - run macros, configured from the command line (see PrintUsage)
  * - start interactive UI mode (no arguments)
  */
 int main(int argc, char** argv) {
+  StartupTimer::Start();
   G4cout<<"Application starting..."<<G4endl;
-//  G4long myseed = 345354;
-//  CLHEP::HepRandom::setTheSeed(myseed);
+
+  CommandLine cl;
+  if (argc > 1 && !ParseCommandLine(argc, argv, cl)) {
+    PrintUsage();
+    return EXIT_FAILURE;
+  }
+
+  // before any ROOT object exists: input files may be read by background
+  // threads (e.g. /gen/hepmc/prefetch with ROOT formats) while the output is filled
+  ROOT::EnableThreadSafety();
+
+  // the event loop is sequential: extra threads go to ROOT for compressing the output
+  if (cl.threads > 1) {
+    ROOT::EnableImplicitMT(cl.threads);
+    G4cout << "Using " << cl.threads << " threads for ROOT I/O" << G4endl;
+  }
 
   // invoke analysis manager before ui manager to invoke analysis manager messenger
   AnalysisManager* analysis = AnalysisManager::GetInstance();
 
+  // keep every applied command: the run tree records the settings from the history
+  G4UImanager::GetUIpointer()->SetMaxHistSize(1000000);
+
   // Create the run manager (MT or non-MT) and make it a bit verbose.
   auto runManager = new G4RunManager();
   runManager->SetVerboseLevel(1);
 
   // Set mandatory initialization classes
   runManager->SetUserInitialization(new DetectorConstruction());
-  
+
   // Set Physics list
+  const G4String physicsListName = "FTFP_BERT";
   G4VUserPhysicsList* physics = new FTFP_BERT;
   runManager->SetUserInitialization(physics);
+  PhysicsTableCache::GetInstance()->SetPhysicsListName(physicsListName);
+  analysis->setPhysicsListName(physicsListName);
 
   // Set user action classes
   runManager->SetUserInitialization(new ActionInitialization());
 
-  // Initialize visualization
-  G4VisManager* visManager = new G4VisExecutive();
-  visManager->SetVerboseLevel(1);   // Default, you can always override this using macro commands
-  visManager->Initialize();
+  // Initialize visualization only for interactive sessions: registering the
+  // graphics systems is a sizeable part of the start-up of short batch jobs
+  G4bool interactive = (argc == 1 || cl.vis);
+#ifdef PINPOINT_WITH_VIS
+  G4VisManager* visManager = nullptr;
+  if (interactive) {
+    visManager = new G4VisExecutive();
+    visManager->SetVerboseLevel(1);   // Default, you can always override this using macro commands
+    visManager->Initialize();
+  }
+#else
+  if (interactive) {
+    G4cerr << "pinpoint was built without visualisation (WITH_GEANT4_UIVIS=OFF), use it in batch mode" << G4endl;
+    return EXIT_FAILURE;
+  }
+#endif
+  StartupTimer::Mark("application constructed");
 
   G4UImanager* UImanager = G4UImanager::GetUIpointer();
 
@@ -52,24 +220,38 @@ int main(int argc, char** argv) {
     ui->SessionStart();
     delete ui;
   } else {
-    //G4UIExecutive* ui = new G4UIExecutive(argc, argv);
-    G4String command = "/control/execute ";
-    G4String fileName = argv[1];
-    UImanager->ApplyCommand(command+fileName);
-    if (argc==3) {
-      G4String mode = argv[2];
-      if (mode == "vis") {
-        G4UIExecutive* ui = new G4UIExecutive(argc, argv);
-        ui->SessionStart();
-        delete ui;
-      } else {
-        G4cout<<"Please specify the second argument as vis to visualize the event"<<G4endl;
-        return 0;
+    // options first, so that the macro can still override them
+    for (const auto& command : OptionCommands(cl)) {
+      G4cout << "Command line option: " << command << G4endl;
+      if (UImanager->ApplyCommand(command) != 0) {
+        G4cerr << "Command failed: " << command << G4endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    if (!cl.macro.empty()) {
+      G4String command = "/control/execute ";
+      UImanager->ApplyCommand(command+cl.macro);
+    }
+
+    if (cl.events > 0) {
+      if (G4StateManager::GetStateManager()->GetCurrentState() == G4State_PreInit) {
+        UImanager->ApplyCommand("/run/initialize");
+        StartupTimer::Mark("run initialised");
       }
+      UImanager->ApplyCommand("/run/beamOn " + std::to_string(cl.events));
+    }
+
+    if (cl.vis) {
+      G4UIExecutive* ui = new G4UIExecutive(argc, argv);
+      ui->SessionStart();
+      delete ui;
     }
   }
 
+#ifdef PINPOINT_WITH_VIS
   delete visManager;
+#endif
   delete runManager;
 
   G4cout<<"Application sucessfully ended.\nBye :-)"<<G4endl;
@@ -0,0 +1,69 @@
+#ifndef pinpoint_ActsHit_hh
+#define pinpoint_ActsHit_hh
+
+#include "G4VHit.hh"
+#include "G4THitsCollection.hh"
+#include "G4Allocator.hh"
+#include "G4LorentzVector.hh"
+
+/// Single Geant4 step inside a sensitive silicon layer, kept in the form
+/// needed for the ACTS simhit output (position/time of the step and the
+/// particle 4-momentum before and after it).
+class ActsHit : public G4VHit
+{
+public:
+  ActsHit() = default;
+  ActsHit(const ActsHit&) = default;
+  ~ActsHit() override = default;
+
+  ActsHit& operator=(const ActsHit&) = default;
+  G4bool operator==(const ActsHit&) const;
+
+  inline void* operator new(size_t);
+  inline void operator delete(void*);
+
+  void Print() override;
+
+  void SetTrackID(G4int trackID) { fTrackID = trackID; }
+  void SetLayerID(G4int layer) { fLayerID = layer; }
+  void SetX4(const G4LorentzVector& x4) { fX4 = x4; }
+  void SetP4Before(const G4LorentzVector& p4) { fP4Before = p4; }
+  void SetP4After(const G4LorentzVector& p4) { fP4After = p4; }
+  void SetEnergyDeposit(G4double edep) { fEnergyDeposit = edep; }
+
+  G4int GetTrackID() const { return fTrackID; }
+  G4int GetLayerID() const { return fLayerID; }
+  const G4LorentzVector& GetX4() const { return fX4; }
+  const G4LorentzVector& GetP4Before() const { return fP4Before; }
+  const G4LorentzVector& GetP4After() const { return fP4After; }
+  G4double GetEnergyDeposit() const { return fEnergyDeposit; }
+
+private:
+  G4int fTrackID = -1;
+  G4int fLayerID = -1;
+  G4LorentzVector fX4 = G4LorentzVector();       // pre-step position and global time
+  G4LorentzVector fP4Before = G4LorentzVector(); // pre-step 4-momentum
+  G4LorentzVector fP4After = G4LorentzVector();  // post-step 4-momentum
+  G4double fEnergyDeposit = 0.0;
+};
+
+
+using ActsHitsCollection = G4THitsCollection<ActsHit>;
+
+extern G4ThreadLocal G4Allocator<ActsHit>* ActsHitAllocator;
+
+
+inline void* ActsHit::operator new(size_t)
+{
+  if (!ActsHitAllocator) ActsHitAllocator = new G4Allocator<ActsHit>;
+  return (void*)ActsHitAllocator->MallocSingle();
+}
+
+
+inline void ActsHit::operator delete(void* hit)
+{
+  ActsHitAllocator->FreeSingle((ActsHit*)hit);
+}
+
+
+#endif
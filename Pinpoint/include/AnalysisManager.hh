@@ -6,13 +6,23 @@
 #include <string>
 
 #include "G4Event.hh"
+#include "G4Track.hh"
+#include "G4LorentzVector.hh"
 #include "TFile.h"
 #include "TTree.h"
 #include "TH2F.h"
+#include "THnSparse.h"
 
 
 #include "AnalysisManagerMessenger.hh"
 #include "FPFParticle.hh"
+#include "PixelGeometry.hh"
+#include "reco/Barcode.hh"
+#include "reco/PixelClustering.hh"
+#include "reco/HitIndex.hh"
+#include "reco/TrackFinder.hh"
+
+class TrackFinderMessenger;
 
 class AnalysisManager {
   public:
@@ -32,6 +42,36 @@ class AnalysisManager {
     // functions for controlling from the configuration file
     void setFileName(std::string val) { fFilename = val; }
     void saveTrack(G4bool val) { fSaveTrack = val; }
+    void saveActs(G4bool val) { fSaveActs = val; }
+    void saveClusters(G4bool val) { fSaveClusters = val; }
+    void setClusterConnectivity(G4int val) { fClustering.SetConnectivity(val); }
+    void dropRawHits(G4bool val) { fDropRawHits = val; }
+    void setPhysicsListName(std::string val) { fPhysicsListName = val; }
+    G4bool GetSaveActs() const { return fSaveActs; }
+    void saveTruthLinks(G4bool val) { fSaveTruthLinks = val; }
+    G4bool GetSaveTruthLinks() const { return fSaveTruthLinks; }
+    void saveHitPositions(G4bool val) { fSaveHitPositions = val; }
+    void saveOccupancy(G4bool val) { fSaveOccupancy = val; }
+    void setOccupancyRebin(G4int val) { fOccupancyRebin = val; }
+    void setModuleSize(G4double width, G4double height) { fModuleWidth = width; fModuleHeight = height; }
+    // "full" (default) or "summary": also write per-event calorimetric profiles
+    void setOutputMode(std::string val) { fSummaryMode = (val == "summary"); }
+    void findTracks(G4bool val) { fFindTracks = val; }
+    TrackFinder& GetTrackFinder() { return fTrackFinder; }
+
+    // current values, recorded in the run tree
+    const std::string& GetFileName() const { return fFilename; }
+    G4bool GetSaveTrack() const { return fSaveTrack; }
+    G4bool GetSaveClusters() const { return fSaveClusters; }
+    G4int GetClusterConnectivity() const { return fClustering.GetConnectivity(); }
+    G4bool GetDropRawHits() const { return fDropRawHits; }
+    G4bool GetSaveHitPositions() const { return fSaveHitPositions; }
+    std::string GetOutputMode() const { return fSummaryMode ? "summary" : "full"; }
+    G4bool GetSaveOccupancy() const { return fSaveOccupancy; }
+    G4int GetOccupancyRebin() const { return fOccupancyRebin; }
+    G4double GetModuleWidth() const { return fModuleWidth; }
+    G4double GetModuleHeight() const { return fModuleHeight; }
+    G4bool GetFindTracks() const { return fFindTracks; }
 
     // build TID to primary ancestor association
     // filled progressively from StackingAction
@@ -41,6 +81,17 @@ class AnalysisManager {
     // TODO: needed???
     void AddOnePrimaryTrack() { nTestNPrimaryTrack++; }
 
+    // spatial index of the pixel hits of the current event, built on first
+    // use and shared by every consumer of the event
+    const HitIndex& GetHitIndex();
+
+    // ACTS particle truth, filled progressively:
+    // registered from StackingAction, material from SteppingAction,
+    // energy loss and outcome from TrackingAction
+    void RegisterActsParticle(const G4Track* track);
+    void FinalizeActsParticle(const G4Track* track);
+    void AddActsMaterial(G4int trackID, G4double pathInX0, G4double pathInL0);
+
   private:
 
     //------------------------------------------------
@@ -50,18 +101,57 @@ class AnalysisManager {
     void bookTrkTree();
     void bookPrimTree();
     void bookHitsTrees();
+    void bookActsTrees();
 
     void FillEventTree(const G4Event* event);
     void FillPrimariesTree(const G4Event* event);
     void FillTrajectoriesTree(const G4Event* event);
     void FillHitsOutput();
+    void FillClusters();
+    void FillSummaryTree(const G4Event* event);
+    void FillTracks();
+    void bookOccupancy();
+    void FillOccupancy();
+    void WriteOccupancy();
+    void FillDigitsOutput(const G4Event* event);
+    void FillActsOutput();
+    // one entry describing the run: geometry, settings, seeds, software,
+    // event counts, resource usage and host, used e.g. by pinpoint_merge
+    void WriteRunTree();
     
     float_t GetTotalEnergy(float_t px, float_t py, float_t pz, float_t m);
 
     static AnalysisManager* fInstance;
     AnalysisManagerMessenger* fMessenger{nullptr};
+    TrackFinderMessenger* fTrackFinderMessenger{nullptr};
 
     G4bool fSaveTrack;
+    G4bool fSaveActs;
+    G4bool fSaveDigits;   // set at the start of the run from /digi/enable
+    G4bool fSaveClusters;
+    G4bool fSaveTruthLinks;
+    G4bool fSaveHitPositions;
+    G4bool fSummaryMode;
+    G4bool fFindTracks;
+    G4bool fSaveOccupancy;
+    G4int fOccupancyRebin;     // pixels per hit map bin along rows and columns
+    G4double fModuleWidth;     // read-out module, along x (rows)
+    G4double fModuleHeight;    // along y (cols)
+
+    // channel <-> position transform, taken from the detector at the start of the run
+    PixelGeometry fPixelGeometry;
+    G4bool fDropRawHits;
+
+    PixelClustering fClustering;
+    HitIndex fHitIndex;
+    G4bool fHitIndexBuilt{false};
+    TrackFinder fTrackFinder;
+
+    // run bookkeeping for the run tree
+    std::string fPhysicsListName;
+    Long64_t fNEventsWritten;
+    G4double fRunStartWallTime;   // seconds since start of the application
+    G4double fRunStartCpuTime;    // seconds of process CPU time
     
     std::map<int, std::string> fSDNamelist;
 
@@ -81,7 +171,21 @@ class AnalysisManager {
 
     TDirectory* fHits;
     TTree*   fPixelHitsTree;
+    TTree*   fPixelDigitsTree;
+    TTree*   fClustersTree;
+    TTree*   fSummaryTree;
+    TTree*   fTracksTree;
+
+    // run-level occupancy, accumulated over the events of the job
+    TDirectory* fOccupancyDir{nullptr};
+    THnSparseF* fHitMap{nullptr};        // (layer, row bin, col bin)
+    TH2F* fModuleHits{nullptr};           // (layer, hits in a module with hits) per event
+    TH1F* fMaxModuleHits{nullptr};        // hits in the busiest module per event
+    TH1F* fHitEdep{nullptr};              // deposit per hit
+    TH2F* fLayerEdep{nullptr};            // (layer, deposit in the layer) per event
+    TH1F* fEventEdep{nullptr};            // deposit per event
     TTree*   fActsParticlesTree;
+    TTree*   fActsHitsTree;
 
     // track to primary ancestor
     std::map<G4int, G4int> trackToPrimaryAncestor;
@@ -89,10 +193,33 @@ class AnalysisManager {
     // TODO: no longer needed?
     G4int nTestNPrimaryTrack;
 
+    // Truth record of a track for the ACTS particle output
+    // the barcode is only assigned when writing, see FillActsOutput
+    struct ActsParticleRecord {
+      G4bool registered = false;
+      ActsFatras::Barcode primaryBarcode; // barcode of the primary ancestor
+      G4int generation = 0;               // number of ancestors up to the primary
+      G4int pdg = 0;
+      G4int process = 0;                  // creator process sub-type, 0 for primaries
+      G4LorentzVector x4;                 // production vertex [mm, ns]
+      G4LorentzVector p4;                 // initial 4-momentum [MeV]
+      G4double mass = 0.;
+      G4double charge = 0.;
+      G4double eLoss = 0.;
+      G4double pathInX0 = 0.;
+      G4double pathInL0 = 0.;
+      G4int nHits = 0;
+      G4int outcome = 0;
+    };
+    // indexed by G4 track ID
+    std::vector<ActsParticleRecord> fActsParticleRecords;
+    // primary particles of the current event to their (vertex, particle) barcode
+    std::map<const G4PrimaryParticle*, ActsFatras::Barcode> fActsPrimaryBarcodes;
+
     //---------------------------------------------------
     // OUTPUT VARIABLES FOR COMMON TREES
 
-    G4int evtID;
+    Long64_t evtID;
     G4int vertexID;
     double weight;
     std::string genType;
@@ -152,18 +279,65 @@ class AnalysisManager {
     // OUTPUT VARIABLES FOR Hits TREES
 
     //* Reco space points
-    UInt_t fPixelEventID;
+    ULong64_t fPixelEventID;
     std::vector<Float_t> fPixelRowIDs;
     std::vector<Float_t> fPixelColIDs;
     std::vector<Float_t> fPixelLayerIDs;
     std::vector<Int_t> fPixelPDGCs;
-    std::vector<UInt_t> fPixelTrackIDs;
+    std::vector<Int_t> fPixelTrackIDs;     // negative for overlaid muons
     // std::vector<UInt_t> fPixelParentID;
     std::vector<Float_t> fPixelPxs;
     std::vector<Float_t> fPixelPys;
     std::vector<Float_t> fPixelPzs;
     std::vector<Float_t> fPixelEnergies;
     std::vector<Float_t> fPixelCharges;
+    std::vector<Int_t> fPixelClusterIDs;
+    std::vector<Float_t> fPixelEdeps;   // not written, cluster weights
+    std::vector<Float_t> fPixelXs;      // pixel centre [mm]
+    std::vector<Float_t> fPixelYs;
+    std::vector<Float_t> fPixelZs;
+    // contributing tracks of every hit, see PixelTruthLinks
+    std::vector<Int_t> fPixelTruthOffsets;
+    std::vector<Int_t> fTruthTrackIDs;
+    std::vector<Float_t> fTruthFractions;
+
+    //* Pixel clusters, see PixelClustering
+    std::vector<Int_t> fClusterLayerIDs;
+    std::vector<Int_t> fClusterSizes;
+    std::vector<Float_t> fClusterEnergies;
+    std::vector<Float_t> fClusterRows;      // deposit weighted centroid, in pixel indices
+    std::vector<Float_t> fClusterCols;
+    std::vector<Int_t> fClusterRowMins, fClusterRowMaxs;
+    std::vector<Int_t> fClusterColMins, fClusterColMaxs;
+
+    //* Calorimetric summary, one entry per event [MeV, mm]
+    Int_t fSummaryNLayers;
+    std::vector<Float_t> fLayerEdeps;       // fixed size nLayers
+    std::vector<Int_t> fLayerNHits;
+    std::vector<Float_t> fLayerMeanRadii;   // deposit weighted, around the primary axis
+    Float_t fSummaryEdep;
+    Int_t fSummaryNHits;
+    Int_t fShowerMaxLayer;
+    Float_t fMeanRadius;
+    Float_t fRmsRadius;
+
+    //* Straight tracks, see TrackFinder [mm]
+    std::vector<Float_t> fTrackX0s, fTrackY0s;   // at z = 0
+    std::vector<Float_t> fTrackTxs, fTrackTys;   // dx/dz, dy/dz
+    std::vector<Float_t> fTrackChi2s;
+    std::vector<Int_t> fTrackNdfs;
+    std::vector<Int_t> fTrackNHits;
+    std::vector<Int_t> fTrackFirstLayers, fTrackLastLayers;
+    std::vector<Int_t> fTrackHitOffsets;   // hits of track i: [offset[i], offset[i+1])
+    std::vector<Int_t> fTrackHitIndices;   // entries of the pixelHits vectors
+    std::vector<Int_t> fTrackTrackIDs;     // most frequent hit_trackID
+    std::vector<Float_t> fTrackPurities;   // share of the hits with that track ID
+
+    //* Digitised pixels
+    std::vector<Int_t> fDigitRowIDs;
+    std::vector<Int_t> fDigitColIDs;
+    std::vector<Int_t> fDigitLayerIDs;
+    std::vector<Float_t> fDigitCharges;   // [electrons]
 
     // Acts Particle Information - need the truth info on the particles in order to do the truth tracking
     std::vector<std::uint64_t> ActsParticlesParticleId;
@@ -194,6 +368,16 @@ class AnalysisManager {
     std::vector<std::int32_t> ActsParticlesNumberOfHits;
     std::vector<std::uint32_t> ActsParticlesOutcome;
 
+    // Acts simhits - one entry per hit, layout of ActsExamples::RootSimHitWriter
+    UInt_t ActsHitsEventId;
+    ULong64_t ActsHitsGeometryId;
+    ULong64_t ActsHitsParticleId;
+    Float_t ActsHitsTx, ActsHitsTy, ActsHitsTz, ActsHitsTt;
+    Float_t ActsHitsTpx, ActsHitsTpy, ActsHitsTpz, ActsHitsTe;
+    Float_t ActsHitsDeltaPx, ActsHitsDeltaPy, ActsHitsDeltaPz, ActsHitsDeltaE;
+    Int_t ActsHitsIndex;
+    UInt_t ActsHitsVolumeId, ActsHitsBoundaryId, ActsHitsLayerId, ActsHitsApproachId, ActsHitsSensitiveId;
+
 };
 
 #endif
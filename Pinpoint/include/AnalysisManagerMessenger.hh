@@ -49,6 +49,7 @@ class AnalysisManagerMessenger: public G4UImessenger
     ~AnalysisManagerMessenger();
 
     void SetNewValue(G4UIcommand* ,G4String );
+    G4String GetCurrentValue(G4UIcommand* );
 
   private:
 
@@ -57,6 +58,16 @@ class AnalysisManagerMessenger: public G4UImessenger
     G4UIdirectory* fOutDir; 
     G4UIcmdWithAString* fFileCmd;
     G4UIcmdWithABool* fSaveTrackCmd; 
+    G4UIcmdWithABool* fSaveActsCmd;
+    G4UIcmdWithABool* fSaveClustersCmd;
+    G4UIcmdWithAnInteger* fClusterConnectivityCmd;
+    G4UIcmdWithABool* fDropRawHitsCmd;
+    G4UIcmdWithABool* fSaveTruthLinksCmd;
+    G4UIcmdWithABool* fSaveHitPositionsCmd;
+    G4UIcmdWithAString* fModeCmd;
+    G4UIcmdWithABool* fSaveOccupancyCmd;
+    G4UIcmdWithAnInteger* fOccupancyRebinCmd;
+    G4UIcommand* fModuleSizeCmd;
 
 };
 
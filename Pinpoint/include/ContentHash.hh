@@ -0,0 +1,26 @@
+#ifndef ContentHash_HH
+#define ContentHash_HH
+
+#include <globals.hh>
+
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <string>
+
+// 16 hex digit 64-bit FNV-1a digest of a string, stable across compilers and
+// platforms, used to name cache entries after the parameters they depend on
+inline G4String ContentHash(const std::string& content)
+{
+  std::uint64_t hash = 14695981039346656037ULL;
+  for (unsigned char c : content) {
+    hash ^= c;
+    hash *= 1099511628211ULL;
+  }
+
+  std::ostringstream hex;
+  hex << std::hex << std::setw(16) << std::setfill('0') << hash;
+  return hex.str();
+}
+
+#endif
@@ -6,6 +6,7 @@
 #include "G4SystemOfUnits.hh"
 #include "DetectorConstructionMessenger.hh"
 #include "G4RunManager.hh"
+#include "PixelGeometry.hh"
 
 class G4VPhysicalVolume;
 
@@ -22,7 +23,31 @@ class DetectorConstruction : public G4VUserDetectorConstruction
     void SetWriteFile(const G4String& File);
     std::vector<G4VPhysicalVolume*> GetTargetPhysVols() const { return fTarget_phys; }
 
-    G4int GetNlayers() const { return fTarget_phys.size(); }
+    G4int GetNlayers() const { return fNLayers; }
+
+    // pixel grid of the silicon layers: "row" copy numbers run along x, "col" along y
+    G4double GetPixelWidth() const { return fPixelWidth; }
+    G4double GetPixelHeight() const { return fPixelHeight; }
+    G4int GetNPixelsX() const { return static_cast<G4int>(fDetectorWidth / fPixelWidth); }
+    G4int GetNPixelsY() const { return static_cast<G4int>(fDetectorHeight / fPixelHeight); }
+
+    G4double GetTungstenThickness() const { return fTungstenThickness; }
+    G4double GetSiliconThickness() const { return fSiliconThickness; }
+    G4double GetDetectorWidth() const { return fDetectorWidth; }
+    G4double GetDetectorHeight() const { return fDetectorHeight; }
+    // tungsten, air gap and silicon, see BuildGeometry(): the gap is the tungsten minus the silicon thickness
+    G4double GetLayerThickness() const { return 2 * fTungstenThickness; }
+
+    // channel <-> position transform of the pixels built from the parameters above
+    PixelGeometry GetPixelGeometry() const
+    {
+      return PixelGeometry(fNLayers, GetNPixelsX(), GetNPixelsY(), fPixelWidth, fPixelHeight,
+                           GetLayerThickness(), fTungstenThickness + 0.5 * fSiliconThickness);
+    }
+
+    // hex digest of every parameter the geometry depends on: names cache
+    // files and identifies the geometry of output files
+    G4String GeometryHash() const;
 
     void SetTungstenThickness(G4double thickness) { 
       if (thickness <= 0) {
@@ -44,11 +69,24 @@ class DetectorConstruction : public G4VUserDetectorConstruction
     void SetDetectorHeight(G4double height) { fDetectorHeight = height; }
     void SetCheckOverlaps(G4bool check) { fCheckOverlaps = check; }
     void SetGDMLFile(const G4String& filename) { fWriteFile = filename; }
+    void SetExportGDML(G4bool save) { fExportGDML = save; }
+    void SetGeometryCache(const G4String& dir) { fCacheDir = dir; }
+    G4bool GetCheckOverlaps() const { return fCheckOverlaps; }
+    const G4String& GetGDMLFile() const { return fWriteFile; }
+    G4bool GetExportGDML() const { return fExportGDML; }
+    const G4String& GetGeometryCache() const { return fCacheDir; }
 
   private:
+    // Construct() from the parameters above
+    G4VPhysicalVolume* BuildGeometry();
+    G4VPhysicalVolume* LoadGeometry(const G4String& file);
+    void WriteGDML(const G4String& file, G4VPhysicalVolume* worldPV);
+
     G4String fWriteFile = "pinpoint.gdml";
+    G4bool fExportGDML = false;
+    G4String fCacheDir;           // empty: no geometry cache
     G4GDMLParser fParser;
-    G4LogicalVolume* fPixelLV;
+    G4LogicalVolume* fPixelLV = nullptr;
 
     DetectorConstructionMessenger* messenger;
 
@@ -60,7 +98,7 @@ class DetectorConstruction : public G4VUserDetectorConstruction
     G4double fDetectorWidth = 26.6 * cm;
     G4double fDetectorHeight = 19.6 * cm;
 
-    G4bool fCheckOverlaps = true;
+    G4bool fCheckOverlaps = false;  // validation mode, slow
 
     std::vector<G4VPhysicalVolume*> fTarget_phys;
 };
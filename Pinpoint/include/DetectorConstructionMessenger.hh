@@ -23,6 +23,7 @@ class DetectorConstructionMessenger: public G4UImessenger {
     ~DetectorConstructionMessenger();
 
     void SetNewValue(G4UIcommand*, G4String);
+    G4String GetCurrentValue(G4UIcommand*);
 
   private:
     DetectorConstruction* det;
@@ -38,8 +39,9 @@ class DetectorConstructionMessenger: public G4UImessenger {
     G4UIcmdWithADoubleAndUnit* detectorWidthCmd;
     G4UIcmdWithADoubleAndUnit* detectorHeightCmd;
     G4UIcmdWithAString* detGdmlCmd;
-
-    // G4UIcmdWithABool* detCheckOverlapCmd;
+    G4UIcmdWithABool* detExportGdmlCmd;
+    G4UIcmdWithAString* detCacheCmd;
+    G4UIcmdWithABool* detCheckOverlapCmd;
 
     // // FLArE
     // G4UIcmdWithABool* detAddFLArECmd;
@@ -21,12 +21,18 @@ class EventInformation : public G4VUserEventInformation
     /// Gets metadata per vertex
     inline GeneratorVertexMetadata GetMetadataPerVertex(int i) const { return fGenMetadata.at(i); }
 
+    /// Position of the event in the whole sample (input entry for file based generators),
+    /// unique across jobs and shards; -1 if unknown
+    inline void SetEventIndex(G4long index) { fEventIndex = index; }
+    inline G4long GetEventIndex() const { return fEventIndex; }
+
     /// Prints the information about the event.
     virtual void Print() const;
 
   private:
     /// Set of vertex metadata
     std::vector<GeneratorVertexMetadata> fGenMetadata;
+    G4long fEventIndex = -1;
 };
 
 #endif
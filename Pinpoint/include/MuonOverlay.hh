@@ -0,0 +1,97 @@
+#ifndef MUONOVERLAY_HH
+#define MUONOVERLAY_HH
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CLHEP/Random/MixMaxRng.h"
+#include "PixelHit.hh"
+#include "globals.hh"
+
+#include "TFile.h"
+#include "TTree.h"
+
+class MuonOverlayMessenger;
+
+// Muon background overlay from a pre-simulated hit library.
+//
+// Library mode (/overlay/writeLibrary): every event of a muon-only run is
+// stored as one library entry holding its pixel hits.
+// Overlay mode (/overlay/library): the library is loaded in memory at the start
+// of the run; each signal event gets K ~ Poisson(rate) random library entries,
+// each shifted by a random transverse offset, merged into its PixelHitsCollection.
+// Overlaid hits carry negative track IDs (-1 - k for the k-th overlaid muon)
+// and are flagged as coming from a muon.
+class MuonOverlay {
+  public:
+    static MuonOverlay* GetInstance();
+
+    void BeginOfRun();
+    void EndOfRun();
+    // called by PixelSD once the pixel hits of the event are built
+    void EndOfEvent(PixelHitsCollection* hits, G4long eventIndex);
+
+    // every library hit overlaid in the last event, also those added to a
+    // pixel hit of the signal event, for the truth links of PixelSD
+    struct Deposit {
+      std::uint64_t pixelKey;   // PixelGeometry::Key
+      G4double edep;
+      G4int trackID;
+    };
+    const std::vector<Deposit>& GetDeposits() const { return fDeposits; }
+
+    void SetWriteLibrary(const std::string& val) { fWriteFilename = val; }
+    void SetLibrary(const std::string& val) { fReadFilename = val; }
+    void SetRate(G4double val) { fRate = val; }
+    void SetMaxShift(G4double val) { fMaxShift = val; }
+    void SetSeed(G4long val) { fSeed = val; }
+    const std::string& GetWriteLibrary() const { return fWriteFilename; }
+    const std::string& GetLibrary() const { return fReadFilename; }
+    G4double GetRate() const { return fRate; }
+    G4double GetMaxShift() const { return fMaxShift; }
+    G4long GetSeed() const { return fSeed; }
+
+  private:
+    MuonOverlay();
+    ~MuonOverlay();
+
+    static MuonOverlay* fInstance;
+    MuonOverlayMessenger* fMessenger;
+
+    void WriteEntry(const PixelHitsCollection* hits);
+    void LoadLibrary();
+    void Overlay(PixelHitsCollection* hits, G4long eventIndex);
+
+    // configuration
+    std::string fWriteFilename;
+    std::string fReadFilename;
+    G4double fRate;      // mean number of overlaid muons per event
+    G4double fMaxShift;  // transverse shifts are uniform in [-fMaxShift, fMaxShift] in x and y
+    G4long fSeed;
+
+    // library writing
+    TFile* fWriteFile;
+    TTree* fWriteTree;
+    std::vector<int> fLayer, fRow, fCol, fPDG, fCharge;
+    std::vector<float> fEdep, fPx, fPy, fPz, fE;
+
+    // loaded library: hits of entry i are fHits[fOffsets[i], fOffsets[i+1])
+    struct LibraryHit {
+      G4int layer, row, col, pdg, charge;
+      G4float edep, px, py, pz, e;
+    };
+    std::string fLoadedFilename;
+    std::vector<LibraryHit> fHits;
+    std::vector<std::uint64_t> fOffsets;
+
+    // pixel grid, taken from the detector at the start of the run
+    G4double fPixelWidth, fPixelHeight;
+    G4int fNPixelsX, fNPixelsY;
+
+    CLHEP::MixMaxRng fEngine;
+    G4long fNOverlaid;   // muons overlaid in this run
+    std::vector<Deposit> fDeposits;
+};
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef MuonOverlayMessenger_h
+#define MuonOverlayMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class MuonOverlay;
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithADouble;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithAnInteger;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class MuonOverlayMessenger: public G4UImessenger
+{
+  public:
+
+    MuonOverlayMessenger(MuonOverlay* );
+    ~MuonOverlayMessenger();
+
+    void SetNewValue(G4UIcommand* ,G4String );
+    G4String GetCurrentValue(G4UIcommand* );
+
+  private:
+
+    MuonOverlay* fOverlay;
+
+    G4UIdirectory* fOverlayDir;
+    G4UIcmdWithAString* fWriteLibraryCmd;
+    G4UIcmdWithAString* fLibraryCmd;
+    G4UIcmdWithADouble* fRateCmd;
+    G4UIcmdWithADoubleAndUnit* fMaxShiftCmd;
+    G4UIcmdWithAnInteger* fSeedCmd;
+
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef PhysicsTableCache_HH
+#define PhysicsTableCache_HH
+
+#include "G4VStateDependent.hh"
+#include "globals.hh"
+
+class PhysicsTableCacheMessenger;
+
+// Opt-in store/retrieve cache of the physics tables.
+//
+// Building the FTFP_BERT tables is most of the cost of /run/initialize plus the
+// first /run/beamOn, which dominates short jobs. With a cache directory set,
+// each set of tables is kept in a sub-directory named after a hash of
+//   Geant4 version, data set versions (G4LEDATA, G4ENSDFSTATEDATA, ...),
+//   physics list, materials and production cuts of every region
+// On the first run of a job an existing, complete entry is retrieved instead of
+// being built; otherwise the freshly built tables are stored for later jobs.
+// Tables rebuilt later in the job (/run/physicsModified, new cuts) are never
+// retrieved, so modified physics cannot be replaced by stale tables.
+//
+// Consistency: an entry only counts once its key file, written last, matches
+// the full key text (not only its hash). Geant4 additionally compares the
+// stored material-cuts couples when retrieving and rebuilds the tables if they
+// differ. Entries are written to a private directory and renamed into place,
+// and a complete entry is never replaced, so concurrent jobs can share one
+// cache while others read from it.
+class PhysicsTableCache : public G4VStateDependent
+{
+  public:
+    static PhysicsTableCache* GetInstance();
+
+    void SetDirectory(const G4String& dir) { fDirectory = dir; }
+    const G4String& GetDirectory() const { return fDirectory; }
+    void SetPhysicsListName(const G4String& name) { fPhysicsListName = name; }
+
+    // follows the run initialisation: Idle -> Init (tables about to be built)
+    // and Init -> Idle (tables built)
+    G4bool Notify(G4ApplicationState requestedState) override;
+
+  private:
+    PhysicsTableCache();
+    ~PhysicsTableCache() override;
+
+    // human readable description of everything the tables depend on
+    G4String CacheKey() const;
+    G4bool IsComplete(const G4String& entry, const G4String& key) const;
+    void Prepare();
+    void Store();
+
+    static PhysicsTableCache* fInstance;
+    PhysicsTableCacheMessenger* fMessenger;
+
+    G4String fDirectory;          // empty: cache disabled
+    G4String fPhysicsListName;
+
+    G4bool fFirstRun;
+    G4bool fStore;                // tables of this run initialisation go to fEntry
+    G4String fKey;
+    G4String fEntry;
+};
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef PhysicsTableCacheMessenger_h
+#define PhysicsTableCacheMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class PhysicsTableCache;
+class G4UIcmdWithAString;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class PhysicsTableCacheMessenger: public G4UImessenger
+{
+  public:
+
+    PhysicsTableCacheMessenger(PhysicsTableCache* );
+    ~PhysicsTableCacheMessenger();
+
+    void SetNewValue(G4UIcommand* ,G4String );
+    G4String GetCurrentValue(G4UIcommand* );
+
+  private:
+
+    PhysicsTableCache* fCache;
+
+    G4UIcmdWithAString* fDirectoryCmd;
+
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
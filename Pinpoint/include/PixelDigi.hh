@@ -0,0 +1,55 @@
+#ifndef PixelDigi_hh
+#define PixelDigi_hh
+
+#include "G4VDigi.hh"
+#include "G4TDigiCollection.hh"
+#include "G4Allocator.hh"
+#include "G4Threading.hh"
+
+// Read-out of one pixel after digitisation: collected charge in electrons,
+// including noise, above threshold
+class PixelDigi : public G4VDigi
+{
+public:
+  PixelDigi() = default;
+  PixelDigi(G4int layer, G4int row, G4int col, G4float charge)
+    : fLayerID(layer), fRowID(row), fColID(col), fCharge(charge) {}
+  ~PixelDigi() override = default;
+
+  inline void* operator new(size_t);
+  inline void operator delete(void*);
+
+  void Print() override;
+
+  G4int GetLayerID() const { return fLayerID; }
+  G4int GetRowID() const { return fRowID; }
+  G4int GetColID() const { return fColID; }
+  G4float GetCharge() const { return fCharge; }
+
+private:
+  G4int fLayerID = -1;
+  G4int fRowID = -1;   // pixel index along x
+  G4int fColID = -1;   // pixel index along y
+  G4float fCharge = 0.f;
+};
+
+
+using PixelDigiCollection = G4TDigiCollection<PixelDigi>;
+
+extern G4ThreadLocal G4Allocator<PixelDigi>* PixelDigiAllocator;
+
+
+inline void* PixelDigi::operator new(size_t)
+{
+  if (!PixelDigiAllocator) PixelDigiAllocator = new G4Allocator<PixelDigi>;
+  return (void*)PixelDigiAllocator->MallocSingle();
+}
+
+
+inline void PixelDigi::operator delete(void* digi)
+{
+  PixelDigiAllocator->FreeSingle((PixelDigi*)digi);
+}
+
+
+#endif
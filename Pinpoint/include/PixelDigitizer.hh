@@ -0,0 +1,71 @@
+#ifndef PixelDigitizer_hh
+#define PixelDigitizer_hh
+
+#include "G4VDigitizerModule.hh"
+#include "globals.hh"
+
+#include <cstdint>
+#include <vector>
+
+class PixelDigitizerMessenger;
+
+// Sensor response of the silicon pixel layers.
+//
+// Run after the pixel SD at the end of every event, it turns the step
+// deposits recorded by PixelSD into the "PixelDigits" collection:
+// - energy is converted to electrons (3.62 eV per electron-hole pair)
+// - every step is split into points along its entry-exit segment and the
+//   charge of each point diffuses with a Gaussian whose width grows with the
+//   square root of the drift distance; it is shared between the pixel of the
+//   point and its eight neighbours
+// - Gaussian noise is added to every pixel with charge, and noise-only pixels
+//   are drawn for the whole detector from the noise tail above threshold
+// - pixels below threshold are suppressed
+// The kernels work on flat arrays and use a tabulated normal CDF, so that
+// events with 10^5-10^6 deposits digitise in milliseconds.
+class PixelDigitizer : public G4VDigitizerModule
+{
+public:
+  explicit PixelDigitizer(const G4String& name);
+  ~PixelDigitizer() override;
+
+  void Digitize() override;
+
+  void SetEnabled(G4bool enabled) { fEnabled = enabled; }
+  G4bool IsEnabled() const { return fEnabled; }
+  void SetThreshold(G4double electrons) { fThreshold = electrons; }
+  void SetNoise(G4double electrons) { fNoise = electrons; }
+  void SetDiffusion(G4double sigma) { fDiffusion = sigma; }
+  void SetNoiseHits(G4bool noiseHits) { fNoiseHits = noiseHits; }
+  G4double GetThreshold() const { return fThreshold; }
+  G4double GetNoise() const { return fNoise; }
+  G4double GetDiffusion() const { return fDiffusion; }
+  G4bool GetNoiseHits() const { return fNoiseHits; }
+
+private:
+  // P(X < t) for a standard normal, linear interpolation in fCdfTable
+  inline G4double NormalCdf(G4double t) const;
+
+  PixelDigitizerMessenger* fMessenger;
+
+  G4bool fEnabled = false;
+  G4double fThreshold = 150.;     // [electrons]
+  G4double fNoise = 5.;           // [electrons]
+  G4double fDiffusion;            // sigma after drifting through the whole sensor
+  G4bool fNoiseHits = true;
+
+  std::vector<G4double> fCdfTable;
+
+  // per event work arrays, kept to avoid reallocations
+  // charge points
+  std::vector<G4float> fPointX, fPointY, fPointSigma, fPointCharge;
+  std::vector<G4int> fPointLayer;
+  // pixel of each point and the charge fractions below its lower edge (a)
+  // and below its upper edge (b), per axis
+  std::vector<G4int> fPointIx, fPointIy;
+  std::vector<G4float> fAx, fBx, fAy, fBy;
+  // (pixel key, charge) contributions, then summed per pixel
+  std::vector<std::pair<std::uint64_t, G4float>> fPixelCharges;
+};
+
+#endif
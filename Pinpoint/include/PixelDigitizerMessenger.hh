@@ -0,0 +1,42 @@
+#ifndef PixelDigitizerMessenger_h
+#define PixelDigitizerMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class PixelDigitizer;
+class G4UIdirectory;
+class G4UIcmdWithABool;
+class G4UIcmdWithADouble;
+class G4UIcmdWithADoubleAndUnit;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class PixelDigitizerMessenger: public G4UImessenger
+{
+  public:
+
+    PixelDigitizerMessenger(PixelDigitizer* );
+    ~PixelDigitizerMessenger();
+
+    void SetNewValue(G4UIcommand* ,G4String );
+    G4String GetCurrentValue(G4UIcommand* );
+
+  private:
+
+    PixelDigitizer* fDigitizer;
+
+    G4UIdirectory* fDigiDir;
+    G4UIcmdWithABool* fEnableCmd;
+    G4UIcmdWithADouble* fThresholdCmd;
+    G4UIcmdWithADouble* fNoiseCmd;
+    G4UIcmdWithADoubleAndUnit* fDiffusionCmd;
+    G4UIcmdWithABool* fNoiseHitsCmd;
+
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef PixelGeometry_hh
+#define PixelGeometry_hh
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Channel <-> position transform of the pixel layers, the one place that
+// knows where a pixel sits; build it with DetectorConstruction::GetPixelGeometry().
+//
+// Layer l spans z in [l, l + 1) * layerPitch (the detector starts at z = 0)
+// with its silicon at siliconZ within the layer; the pixel grid is centred on
+// the beam axis, "row" runs along x and "col" along y. Positions are pixel
+// centres in mm (Geant4 units). The conversions are pure arithmetic without
+// branches so that the batch versions vectorise; channel indices of
+// positions outside the detector are not clamped, check them with Contains().
+class PixelGeometry
+{
+  public:
+    // 64-bit key of a channel, the one packing used to look pixels up, sort
+    // them (by layer, row, col) and link them to their truth: 21 bits each for
+    // row and col, which must be in [0, 2^21) (bias negative indices first)
+    static constexpr int kKeyBits = 21;
+    static constexpr std::uint64_t kKeyMask = (std::uint64_t(1) << kKeyBits) - 1;
+    static constexpr std::uint64_t Key(int layer, int row, int col)
+    {
+      return (static_cast<std::uint64_t>(layer) << (2 * kKeyBits)) | ((static_cast<std::uint64_t>(row) & kKeyMask) << kKeyBits) |
+             (static_cast<std::uint64_t>(col) & kKeyMask);
+    }
+    static constexpr int KeyLayer(std::uint64_t key) { return static_cast<int>(key >> (2 * kKeyBits)); }
+    static constexpr int KeyRow(std::uint64_t key) { return static_cast<int>((key >> kKeyBits) & kKeyMask); }
+    static constexpr int KeyCol(std::uint64_t key) { return static_cast<int>(key & kKeyMask); }
+
+    constexpr PixelGeometry() = default;
+    constexpr PixelGeometry(int nLayers, int nRows, int nCols, double pitchX, double pitchY,
+                            double layerPitch, double siliconZ)
+      : fNLayers(nLayers), fNRows(nRows), fNCols(nCols), fPitchX(pitchX), fPitchY(pitchY),
+        fLayerPitch(layerPitch), fX0(-0.5 * nRows * pitchX), fY0(-0.5 * nCols * pitchY), fZ0(siliconZ) {}
+
+    constexpr int GetNLayers() const { return fNLayers; }
+    constexpr int GetNRows() const { return fNRows; }
+    constexpr int GetNCols() const { return fNCols; }
+    constexpr double GetPitchX() const { return fPitchX; }
+    constexpr double GetPitchY() const { return fPitchY; }
+    constexpr double GetLayerPitch() const { return fLayerPitch; }
+
+    // centre of a channel
+    constexpr double X(int row) const { return fX0 + (row + 0.5) * fPitchX; }
+    constexpr double Y(int col) const { return fY0 + (col + 0.5) * fPitchY; }
+    constexpr double Z(int layer) const { return fZ0 + layer * fLayerPitch; }
+
+    // channel containing a position
+    int Row(double x) const { return static_cast<int>(std::floor((x - fX0) / fPitchX)); }
+    int Col(double y) const { return static_cast<int>(std::floor((y - fY0) / fPitchY)); }
+    int Layer(double z) const { return static_cast<int>(std::floor(z / fLayerPitch)); }
+
+    constexpr bool Contains(int layer, int row, int col) const
+    {
+      return layer >= 0 && layer < fNLayers && row >= 0 && row < fNRows && col >= 0 && col < fNCols;
+    }
+
+    // n channels to their centres; T is any integer or floating point type
+    template <class T, class U>
+    void ToGlobal(std::size_t n, const T* layer, const T* row, const T* col, U* x, U* y, U* z) const
+    {
+      for (std::size_t i = 0; i < n; ++i) {
+        x[i] = static_cast<U>(fX0 + (row[i] + 0.5) * fPitchX);
+        y[i] = static_cast<U>(fY0 + (col[i] + 0.5) * fPitchY);
+        z[i] = static_cast<U>(fZ0 + layer[i] * fLayerPitch);
+      }
+    }
+
+    // n positions to their channels
+    template <class T, class U>
+    void ToChannel(std::size_t n, const U* x, const U* y, const U* z, T* layer, T* row, T* col) const
+    {
+      const double invX = 1. / fPitchX, invY = 1. / fPitchY, invZ = 1. / fLayerPitch;
+      for (std::size_t i = 0; i < n; ++i) {
+        row[i] = static_cast<T>(std::floor((x[i] - fX0) * invX));
+        col[i] = static_cast<T>(std::floor((y[i] - fY0) * invY));
+        layer[i] = static_cast<T>(std::floor(z[i] * invZ));
+      }
+    }
+
+  private:
+    int fNLayers = 0;
+    int fNRows = 0;
+    int fNCols = 0;
+    double fPitchX = 1.;
+    double fPitchY = 1.;
+    double fLayerPitch = 1.;
+    double fX0 = 0.;     // lower edge of row 0
+    double fY0 = 0.;     // lower edge of col 0
+    double fZ0 = 0.;     // silicon centre of layer 0
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define fasernux_PixelSD_hh
 
 #include "PixelHit.hh"
+#include "ActsHit.hh"
 #include "G4VSensitiveDetector.hh"
 #include <set>
 #include <tuple>
@@ -10,6 +11,41 @@
 class G4Step;
 class G4HCofThisEvent;
 
+// Energy deposits of one event as segments in the frame of their silicon
+// layer (x, y in the pixel plane, z across the sensor), one entry per step,
+// stored as structure of arrays for the digitisation kernels
+struct PixelDeposits {
+  std::vector<G4int> layer;
+  std::vector<G4float> x0, y0, z0;   // step entry [mm]
+  std::vector<G4float> x1, y1, z1;   // step exit [mm]
+  std::vector<G4float> edep;         // [MeV]
+
+  std::size_t size() const { return edep.size(); }
+  void clear()
+  {
+    layer.clear();
+    x0.clear(); y0.clear(); z0.clear();
+    x1.clear(); y1.clear(); z1.clear();
+    edep.clear();
+  }
+};
+
+// Tracks contributing to every pixel hit of one event, in compressed sparse
+// row form: the links of hit i are [offset[i], offset[i + 1]) (or up to the
+// end of the arrays for the last hit), ordered by decreasing deposit
+struct PixelTruthLinks {
+  std::vector<G4int> offset;        // per hit
+  std::vector<G4int> trackID;       // per link
+  std::vector<G4float> fraction;    // per link, share of the deposit in the pixel
+
+  void clear()
+  {
+    offset.clear();
+    trackID.clear();
+    fraction.clear();
+  }
+};
+
 class PixelSD : public G4VSensitiveDetector
 {
 public:
@@ -25,6 +61,11 @@ public:
   static G4bool IsFromMuon(G4int trackID);
   static void ClearMuonHistory();
 
+  // step deposits of the current event, only recorded while digitisation is enabled
+  const PixelDeposits& GetDeposits() const { return fDeposits; }
+  // contributing tracks of every hit of the current event, only filled with /out/saveTruthLinks
+  const PixelTruthLinks& GetTruthLinks() const { return fTruthLinks; }
+
   // Static method to track descendants of primary lepton (trackId 1)
   // static void RecordTrackParent(G4int trackID, G4int parentID);
   // static G4bool IsFromPrimaryTrack(G4int trackID);
@@ -32,6 +73,13 @@ public:
 
 private:
   PixelHitsCollection* fHitsCollection = nullptr;
+  // Per-step hits for the ACTS simhit output (only filled if /out/saveActs is set)
+  ActsHitsCollection* fActsHitsCollection = nullptr;
+  G4bool fSaveActs = false;
+  PixelDeposits fDeposits;
+  G4bool fRecordDeposits = false;
+  PixelTruthLinks fTruthLinks;
+  G4bool fSaveTruthLinks = false;
   // Static set to track all descendants of the primary lepton (trackId 1)
   static std::set<G4int> sPrimaryDescendants;
   // Static set to track particles that have already hit each layer: (trackID, layerID)
@@ -15,6 +15,7 @@ class PrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
     
     void GeneratePrimaries(G4Event* anEvent) override;
     void SetGenerator(G4String name);
+    G4String GetGeneratorName() const;
 
   private:
 
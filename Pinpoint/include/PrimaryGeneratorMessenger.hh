@@ -7,6 +7,7 @@
 
 class PrimaryGeneratorAction;
 class G4UIdirectory;
+class G4UIcommand;
 class G4UIcmdWithAString;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -18,12 +19,14 @@ class PrimaryGeneratorMessenger: public G4UImessenger
     ~PrimaryGeneratorMessenger();
 
     void SetNewValue(G4UIcommand*, G4String);
+    G4String GetCurrentValue(G4UIcommand*);
     
   private:
     PrimaryGeneratorAction* fPrimGenAction;
 
     G4UIdirectory* fGeneratorDir;
     G4UIcmdWithAString* fGeneratorOption;
+    G4UIcommand* fPseudoParticleCmd;
 
 };
 
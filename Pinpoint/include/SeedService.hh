@@ -0,0 +1,48 @@
+#ifndef SEEDSERVICE_HH
+#define SEEDSERVICE_HH
+
+#include <cstdint>
+
+#include "globals.hh"
+
+class SeedServiceMessenger;
+
+// Deterministic seeding of every random stream from one master seed.
+//
+// Before each event is generated the Geant4 engine is reseeded from
+// hash(master seed, event index), where the event index is the position of
+// the event in the whole sample (the input entry for file based generators).
+// An event is therefore simulated identically whatever job, shard or thread
+// processes it, and can be re-simulated alone.
+// Helpers with their own engines (vertex sampling, overlay) derive their
+// seeds from the same master seed through a separate stream number.
+class SeedService {
+  public:
+    // independent random streams
+    enum Stream { kEventStream = 0, kVertexStream = 1, kOverlayStream = 2 };
+
+    static SeedService* GetInstance();
+
+    void SetMasterSeed(G4long seed);
+    G4long GetMasterSeed() const { return fMasterSeed; }
+
+    // reseed the Geant4 engine for the event with this index
+    void SeedEvent(G4long eventIndex) const;
+
+    // 64-bit seed of a stream for a given key (e.g. event index)
+    std::uint64_t StreamSeed(G4int stream, G4long streamSeed, G4long key) const;
+
+    // splitmix64 finaliser of a combination of a and b
+    static std::uint64_t Mix(std::uint64_t a, std::uint64_t b);
+
+  private:
+    SeedService();
+    ~SeedService();
+
+    static SeedService* fInstance;
+    SeedServiceMessenger* fMessenger;
+
+    G4long fMasterSeed;
+};
+
+#endif
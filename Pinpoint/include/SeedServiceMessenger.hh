@@ -0,0 +1,34 @@
+#ifndef SeedServiceMessenger_h
+#define SeedServiceMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class SeedService;
+class G4UIcmdWithAString;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class SeedServiceMessenger: public G4UImessenger
+{
+  public:
+
+    SeedServiceMessenger(SeedService* );
+    ~SeedServiceMessenger();
+
+    void SetNewValue(G4UIcommand* ,G4String );
+    G4String GetCurrentValue(G4UIcommand* );
+
+  private:
+
+    SeedService* fSeedService;
+
+    G4UIcmdWithAString* fMasterSeedCmd;
+
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef StartupTimer_HH
+#define StartupTimer_HH
+
+#include <globals.hh>
+
+#include <chrono>
+
+// Wall-clock time since the start of main(), used to follow the
+// initialisation cost of short batch jobs. Every mark prints one line
+//   [startup] <phase>: <seconds> s
+// which benchmark_startup.py collects.
+class StartupTimer
+{
+  public:
+    // call first thing in main()
+    static void Start() { Origin() = std::chrono::steady_clock::now(); }
+
+    static G4double Elapsed()
+    {
+      return std::chrono::duration<G4double>(std::chrono::steady_clock::now() - Origin()).count();
+    }
+
+    static void Mark(const G4String& phase)
+    {
+      G4cout << "[startup] " << phase << ": " << Elapsed() << " s" << G4endl;
+    }
+
+    // marks the first event of the job only
+    static void MarkFirstEvent()
+    {
+      static G4bool marked = false;
+      if (marked) return;
+      marked = true;
+      Mark("first event");
+    }
+
+  private:
+    static std::chrono::steady_clock::time_point& Origin()
+    {
+      static std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+      return origin;
+    }
+};
+
+#endif
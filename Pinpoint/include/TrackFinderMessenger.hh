@@ -0,0 +1,48 @@
+#ifndef TrackFinderMessenger_h
+#define TrackFinderMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class AnalysisManager;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithABool;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADouble;
+class G4UIcmdWithADoubleAndUnit;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class TrackFinderMessenger: public G4UImessenger
+{
+  public:
+
+    TrackFinderMessenger(AnalysisManager* );
+    ~TrackFinderMessenger();
+
+    void SetNewValue(G4UIcommand* ,G4String );
+    G4String GetCurrentValue(G4UIcommand* );
+
+  private:
+
+    AnalysisManager* fAnalysisManager;
+
+    G4UIdirectory* fRecoDir;
+    G4UIcmdWithABool* fFindTracksCmd;
+    G4UIcmdWithAnInteger* fMinHitsCmd;
+    G4UIcmdWithADouble* fMaxSlopeCmd;
+    G4UIcmdWithADoubleAndUnit* fToleranceCmd;
+    G4UIcmdWithAnInteger* fMaxMissingCmd;
+    G4UIcmdWithADouble* fMaxChi2Cmd;
+    G4UIcommand* fIsolationCmd;
+    G4UIcmdWithAnInteger* fMaxTracksCmd;
+    G4UIcmdWithAnInteger* fMaxSeedsCmd;
+
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef BoundedQueue_HH
+#define BoundedQueue_HH
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+// Fixed-capacity FIFO shared between threads.
+// Push blocks while the queue is full and Pop while it is empty, so a producer
+// can run at most `capacity` items ahead of its consumers. Any number of
+// producers and consumers may use the queue at the same time.
+// Close() wakes everybody up: further pushes are refused and consumers drain
+// the remaining items before Pop reports the end.
+template <typename T>
+class BoundedQueue
+{
+  public:
+    explicit BoundedQueue(std::size_t capacity) : fCapacity(capacity ? capacity : 1), fClosed(false) {}
+
+    // returns false if the queue was closed and the item was dropped
+    bool Push(T item)
+    {
+      std::unique_lock<std::mutex> lock(fMutex);
+      fNotFull.wait(lock, [this] { return fClosed || fItems.size() < fCapacity; });
+      if (fClosed) return false;
+      fItems.push_back(std::move(item));
+      lock.unlock();
+      fNotEmpty.notify_one();
+      return true;
+    }
+
+    // returns false once the queue is closed and empty
+    bool Pop(T& item)
+    {
+      std::unique_lock<std::mutex> lock(fMutex);
+      fNotEmpty.wait(lock, [this] { return fClosed || !fItems.empty(); });
+      if (fItems.empty()) return false;
+      item = std::move(fItems.front());
+      fItems.pop_front();
+      lock.unlock();
+      fNotFull.notify_one();
+      return true;
+    }
+
+    void Close()
+    {
+      {
+        std::lock_guard<std::mutex> lock(fMutex);
+        fClosed = true;
+      }
+      fNotFull.notify_all();
+      fNotEmpty.notify_all();
+    }
+
+  private:
+    std::size_t fCapacity;
+    bool fClosed;
+    std::deque<T> fItems;
+    std::mutex fMutex;
+    std::condition_variable fNotFull;
+    std::condition_variable fNotEmpty;
+};
+
+#endif
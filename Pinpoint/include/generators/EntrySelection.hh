@@ -0,0 +1,57 @@
+#ifndef ENTRY_SELECTION_HH
+#define ENTRY_SELECTION_HH
+
+#include <algorithm>
+#include <string>
+
+#include "globals.hh"
+#include "G4Exception.hh"
+
+// Entries of an input file read by one job:
+// the range [start, start+count) of the file, split into nShards shards
+// either as contiguous blocks or by taking every nShards-th entry.
+// Shared by the generators reading external files.
+struct EntrySelection
+{
+  G4long first = 0;   ///< first entry read
+  G4long end = 0;     ///< one past the last entry that may be read
+  G4long stride = 1;  ///< step between consecutive entries
+
+  /// Entry read for the i-th generated event
+  G4long Entry(G4long i) const { return first + i*stride; }
+
+  /// Number of entries in the selection
+  G4long Size() const { return (end > first) ? (end - first + stride - 1) / stride : 0; }
+
+  static EntrySelection Resolve(G4long nEntries, G4long start, G4long count,
+                                G4int shardIdx, G4int nShards, G4bool strided)
+  {
+    if (nShards < 1 || shardIdx < 0 || shardIdx >= nShards) {
+      G4String err = "Invalid shard " + std::to_string(shardIdx) + " of " + std::to_string(nShards);
+      G4Exception("EntrySelection", "InvalidShard", FatalErrorInArgument, err.c_str());
+    }
+
+    // range requested by the user, clipped to the input
+    start = std::min(std::max(start, 0L), nEntries);
+    G4long rangeEnd = (count < 0) ? nEntries : std::min(start + count, nEntries);
+
+    EntrySelection sel;
+    if (strided) {
+      // shard i takes entries start+i, start+i+N, ...
+      sel.first = start + shardIdx;
+      sel.end = rangeEnd;
+      sel.stride = nShards;
+    } else {
+      // shard i takes the i-th contiguous block, the first shards get one extra entry if needed
+      G4long n = rangeEnd - start;
+      G4long base = n / nShards;
+      G4long extra = n % nShards;
+      sel.first = start + shardIdx*base + std::min<G4long>(shardIdx, extra);
+      sel.end = sel.first + base + ((shardIdx < extra) ? 1 : 0);
+      sel.stride = 1;
+    }
+    return sel;
+  }
+};
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef EntrySelectionCommands_h
+#define EntrySelectionCommands_h
+
+#include "globals.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class GeneratorBase;
+class G4UImessenger;
+class G4UIcommand;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+// <directory>range and <directory>shard commands of the generators reading
+// external files (see EntrySelection). Created by the messenger of the
+// generator, which forwards its SetNewValue calls to Apply.
+class EntrySelectionCommands
+{
+  public:
+    // entries: what the input holds, e.g. "gst entries", used in the guidance
+    EntrySelectionCommands(G4UImessenger* messenger, const G4String& directory, const G4String& entries);
+    ~EntrySelectionCommands();
+
+    // applies command to the generator, false if it is not one of these commands
+    G4bool Apply(G4UIcommand* command, const G4String& newValues, GeneratorBase* generator) const;
+    // current value of command, empty if it is not one of these commands
+    G4String GetCurrentValue(G4UIcommand* command, const GeneratorBase* generator) const;
+
+  private:
+    G4UIcommand* fRangeCmd;
+    G4UIcommand* fShardCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
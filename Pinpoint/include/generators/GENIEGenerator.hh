@@ -2,6 +2,8 @@
 #define GENIEGenerator_HH
 
 #include "generators/GeneratorBase.hh"
+#include "generators/EntrySelection.hh"
+#include "generators/VertexSampler.hh"
 #include "G4ParticleDefinition.hh"
 
 #include "TFile.h"
@@ -19,20 +21,56 @@ class GENIEGenerator : public GeneratorBase
     // override methods from common base class
     void LoadData() override;
     void GeneratePrimaries(G4Event *anEvent) override;
+    G4long GetNextEventIndex(const G4Event*) const override { return fEntries.Entry(fEventCounter); }
 
     // setter methods for messenger
     void SetGSTFilename(G4String val) { fGSTFilename = val; }
     void SetEvtStartIdx(G4int val) { fEvtStartIdx = val; }
+    void SetEntryRange(G4int start, G4int count) override { fEvtStartIdx = start; fEvtCount = count; }
+    void SetShard(G4int index, G4int nShards, G4bool strided) override { fShardIdx = index; fNShards = nShards; fShardStrided = strided; }
     void SetRandomVertex(G4bool val) { fRandomVtx = val; }
+    void SetVertexWeighting(G4String val) { fVtxWeighting = val; }
+    void SetVertexSeed(G4long val) { fVtxSeed = val; }
+    void SetCacheSize(G4int val) { fCacheSize = val; }
+    void SetCacheLearnEntries(G4int val) { fCacheLearnEntries = val; }
+    void SetPrefetch(G4bool val) { fPrefetch = val; }
+
+    // getter methods for messenger
+    const G4String& GetGSTFilename() const { return fGSTFilename; }
+    G4int GetEvtStartIdx() const { return fEvtStartIdx; }
+    void GetEntryRange(G4int& start, G4int& count) const override { start = fEvtStartIdx; count = fEvtCount; }
+    void GetShard(G4int& index, G4int& nShards, G4bool& strided) const override { index = fShardIdx; nShards = fNShards; strided = fShardStrided; }
+    G4bool GetRandomVertex() const { return fRandomVtx; }
+    const G4String& GetVertexWeighting() const { return fVtxWeighting; }
+    G4long GetVertexSeed() const { return fVtxSeed; }
+    G4int GetCacheSize() const { return fCacheSize; }
+    G4int GetCacheLearnEntries() const { return fCacheLearnEntries; }
+    G4bool GetPrefetch() const { return fPrefetch; }
 
   private:
     G4String fGSTFilename;
     G4int fEventCounter;
     G4int fEvtStartIdx;
     G4bool fRandomVtx;
+    G4String fVtxWeighting;  // mass or volume
+    G4long fVtxSeed;
+    VertexSampler* fVertexSampler; // built in LoadData if fRandomVtx
+
+    // entry selection: range [fEvtStartIdx, fEvtStartIdx+fEvtCount) split in shards
+    G4int fEvtCount;        // number of entries in the range, -1 for all
+    G4int fShardIdx;
+    G4int fNShards;
+    G4bool fShardStrided;   // shards take every fNShards-th entry instead of a contiguous block
+    EntrySelection fEntries; // resolved in LoadData
     TFile *fGSTFile;
     TTree *fGSTTree;
 
+    // input reading
+    G4int fCacheSize;         // TTreeCache size in MB
+    G4int fCacheLearnEntries; // entries used by the cache to learn the branches read
+    G4bool fPrefetch;         // asynchronous prefetch of the next cache cluster
+    Long64_t fBytesRead;      // bytes read from the input up to the last event
+
     // gst tree branches
     // define the branches we are interested in from the GST tree
     const G4int fkNPmax = 250;
@@ -51,11 +89,9 @@ class GENIEGenerator : public GeneratorBase
     G4double m_x, m_y, m_Q2, m_W;
 
     // specific internal functions
-    G4bool FindParticleDefinition(G4int pdg, G4ParticleDefinition* &particleDefinition) const;
     G4int DecodeInteractionType() const;
     G4int DecodeScatteringType() const;
     G4String EncodeProcessName() const;
-    G4ThreeVector GenerateRandomPoint(G4int currentIdx) const;
 };
 
 #endif
@@ -11,6 +11,7 @@ class G4UIdirectory;
 class G4UIcmdWithAString;
 class G4UIcmdWithAnInteger;
 class G4UIcmdWithABool;
+class EntrySelectionCommands;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -21,6 +22,7 @@ class GENIEGeneratorMessenger: public G4UImessenger
     ~GENIEGeneratorMessenger();
 
     void SetNewValue(G4UIcommand*, G4String);
+    G4String GetCurrentValue(G4UIcommand*);
     
   private:
     GENIEGenerator* fGENIEAction;
@@ -29,6 +31,12 @@ class GENIEGeneratorMessenger: public G4UImessenger
     G4UIcmdWithAString* fGSTInputFileCmd;
     G4UIcmdWithAnInteger* fGSTEvtStartIdxCmd;
     G4UIcmdWithABool* fRandomVtxCmd;
+    G4UIcmdWithAString* fVtxWeightingCmd;
+    G4UIcmdWithAnInteger* fVtxSeedCmd;
+    G4UIcmdWithAnInteger* fCacheSizeCmd;
+    G4UIcmdWithAnInteger* fCacheLearnEntriesCmd;
+    G4UIcmdWithABool* fPrefetchCmd;
+    EntrySelectionCommands* fEntrySelectionCmds;
 
 };
 
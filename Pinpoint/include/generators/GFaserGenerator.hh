@@ -0,0 +1,92 @@
+#ifndef GFaserGenerator_HH
+#define GFaserGenerator_HH
+
+#include <deque>
+#include <vector>
+
+#include "generators/GeneratorBase.hh"
+#include "generators/EntrySelection.hh"
+#include "generators/VertexSampler.hh"
+
+#include "G4ThreeVector.hh"
+#include "TFile.h"
+#include "TTree.h"
+#include "globals.hh"
+
+class G4Event;
+class TBranch;
+
+// Reads the gFaser tree written by the FASER GENIE application directly,
+// replacing the gFaser -> HepMC conversion (GenieOutput/convert_gfaser_to_hepmc.py).
+// One entry holds the full GENIE event record; the stable (status 1)
+// particles are passed to Geant4 from a single vertex.
+class GFaserGenerator : public GeneratorBase
+{
+  public:
+    GFaserGenerator();
+    ~GFaserGenerator();
+
+    // override methods from common base class
+    void LoadData() override;
+    void GeneratePrimaries(G4Event *anEvent) override;
+    G4long GetNextEventIndex(const G4Event*) const override { return fEntries.Entry(fEventCounter); }
+
+    // setter methods for messenger
+    void SetFilename(G4String val) { fFilename = val; }
+    void SetEntryRange(G4int start, G4int count) override { fEvtStartIdx = start; fEvtCount = count; }
+    void SetShard(G4int index, G4int nShards, G4bool strided) override { fShardIdx = index; fNShards = nShards; fShardStrided = strided; }
+    void SetVertexOffset(G4ThreeVector val) { fVtxOffset = val; }
+    void SetRandomVertex(G4bool val) { fRandomVtx = val; }
+    void SetVertexSeed(G4long val) { fVtxSeed = val; }
+    void SetCacheSize(G4int val) { fCacheSize = val; }
+
+    // getter methods for messenger
+    const G4String& GetFilename() const { return fFilename; }
+    void GetEntryRange(G4int& start, G4int& count) const override { start = fEvtStartIdx; count = fEvtCount; }
+    void GetShard(G4int& index, G4int& nShards, G4bool& strided) const override { index = fShardIdx; nShards = fNShards; strided = fShardStrided; }
+    const G4ThreeVector& GetVertexOffset() const { return fVtxOffset; }
+    G4bool GetRandomVertex() const { return fRandomVtx; }
+    G4long GetVertexSeed() const { return fVtxSeed; }
+    G4int GetCacheSize() const { return fCacheSize; }
+
+  private:
+    G4String fFilename;
+    TFile* fFile;
+    TTree* fTree;
+    G4int fCacheSize;  // TTreeCache size in MB
+
+    // entry selection: range [fEvtStartIdx, fEvtStartIdx+fEvtCount) split in shards
+    G4int fEventCounter;
+    G4int fEvtStartIdx;
+    G4int fEvtCount;   // -1 for all
+    G4int fShardIdx;
+    G4int fNShards;
+    G4bool fShardStrided;
+    EntrySelection fEntries;
+
+    // vertex: position in the file shifted by fVtxOffset, or sampled in the targets
+    G4ThreeVector fVtxOffset;
+    G4bool fRandomVtx;
+    G4long fVtxSeed;
+    VertexSampler* fVertexSampler;
+
+    // gFaser tree branches. The per-particle lists are either std::vector
+    // branches, filled in place, or fixed arrays counted by n, read into the
+    // vectors sized to the largest record in the file
+    G4bool fListsAreVectors;
+    G4int m_n;
+    std::vector<G4int> m_pdgc, m_status;
+    std::vector<G4int> m_firstMother, m_lastMother, m_firstDaughter, m_lastDaughter;
+    std::vector<G4double> m_px, m_py, m_pz, m_E, m_M;
+    G4double m_vx, m_vy, m_vz;  // in m
+    // addresses handed to ROOT for the std::vector branches, must stay valid
+    std::deque<std::vector<G4int>*> fIntListAddresses;
+    std::deque<std::vector<G4double>*> fDoubleListAddresses;
+
+    // binds a branch after checking that its type is T, or a list of T
+    template <typename T> void SetScalarBranch(const char* name, T* address);
+    template <typename T> void SetListBranch(const char* name, std::vector<T>& list, std::size_t nMax);
+    TBranch* GetBranch(const char* name) const;
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef GFaserGeneratorMessenger_h
+#define GFaserGeneratorMessenger_h
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class GFaserGenerator;
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithABool;
+class G4UIcmdWith3VectorAndUnit;
+class EntrySelectionCommands;
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class GFaserGeneratorMessenger: public G4UImessenger
+{
+  public:
+    GFaserGeneratorMessenger(GFaserGenerator*);
+    ~GFaserGeneratorMessenger();
+
+    void SetNewValue(G4UIcommand*, G4String);
+    G4String GetCurrentValue(G4UIcommand*);
+    
+  private:
+    GFaserGenerator* fGFaserAction;
+
+    G4UIdirectory* fGFaserGeneratorDir;
+    G4UIcmdWithAString* fInputFileCmd;
+    G4UIcmdWith3VectorAndUnit* fVertexOffsetCmd;
+    G4UIcmdWithABool* fRandomVtxCmd;
+    G4UIcmdWithAnInteger* fVtxSeedCmd;
+    G4UIcmdWithAnInteger* fCacheSizeCmd;
+    EntrySelectionCommands* fEntrySelectionCmds;
+
+};
+
+#endif
@@ -4,6 +4,7 @@
 #include <vector>
 #include "G4Event.hh"
 #include "G4UImessenger.hh"
+#include "G4Exception.hh"
 #include "generators/GeneratorVertexMetadata.hh"
 
 class GeneratorBase
@@ -20,6 +21,19 @@ class GeneratorBase
     // Called for each event to generate primaries
     virtual void GeneratePrimaries(G4Event *event) = 0;
 
+    // Index of the event about to be generated in the whole sample, used to seed it.
+    // Generators reading files return the input entry, so that the seed does not
+    // depend on how the input is split between jobs.
+    virtual G4long GetNextEventIndex(const G4Event* event) const { return event->GetEventID(); }
+
+    // entry selection of the generators reading external files, set through
+    // EntrySelectionCommands: range [start, start+count) (count -1 for all),
+    // split into nShards contiguous or strided shards
+    virtual void SetEntryRange(G4int /*start*/, G4int /*count*/) { NoEntrySelection(); }
+    virtual void SetShard(G4int /*index*/, G4int /*nShards*/, G4bool /*strided*/) { NoEntrySelection(); }
+    virtual void GetEntryRange(G4int& start, G4int& count) const { start = 0; count = -1; }
+    virtual void GetShard(G4int& index, G4int& nShards, G4bool& strided) const { index = 0; nShards = 1; strided = false; }
+
     // return name of current generator
     G4String GetGeneratorName() const { return fGeneratorName; }
 
@@ -33,6 +47,12 @@ class GeneratorBase
 
   protected : 
 
+    void NoEntrySelection() const
+    {
+      G4String err = "The " + fGeneratorName + " generator does not read input entries";
+      G4Exception("GeneratorBase", "NoEntrySelection", JustWarning, err.c_str());
+    }
+
     G4String fGeneratorName; 
     G4UImessenger* fMessenger;
     std::vector<GeneratorVertexMetadata> fVertexMetadata;
@@ -0,0 +1,37 @@
+#ifndef HepMCEventIndex_HH
+#define HepMCEventIndex_HH
+
+#include <cstdint>
+#include <vector>
+
+#include "globals.hh"
+
+// Byte offset of every event ('E' record) in a HepMC ASCII file (HepMC2 or HepMC3).
+// The index is built once by a fast scan of the file and cached next to it
+// as <file>.idx, together with the size and modification time of the input
+// so that a stale index is rebuilt automatically.
+class HepMCEventIndex
+{
+  public:
+    explicit HepMCEventIndex(const G4String& filename);
+    ~HepMCEventIndex() = default;
+
+    // read the cached index or build (and cache) a new one
+    G4bool Load();
+
+    std::size_t GetNEvents() const { return fOffsets.size(); }
+    std::uint64_t GetOffset(std::size_t i) const { return fOffsets.at(i); }
+
+  private:
+    G4bool ReadSidecar();
+    G4bool Build();
+    void WriteSidecar() const;
+
+    G4String fFilename;
+    G4String fIndexFilename;
+    std::uint64_t fFileSize;
+    std::int64_t fFileMTime;
+    std::vector<std::uint64_t> fOffsets;
+};
+
+#endif
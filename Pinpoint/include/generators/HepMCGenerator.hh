@@ -2,14 +2,21 @@
 #define HepMCGenerator_HH
 
 #include "generators/GeneratorBase.hh"
+#include "generators/EntrySelection.hh"
+#include "generators/BoundedQueue.hh"
 
 #include "HepMC3/ReaderAscii.h"
 #include "HepMC3/ReaderAsciiHepMC2.h"
 #include <HepMC3/Print.h>
 
+#include <istream>
+#include <thread>
+#include <utility>
+
 #include "globals.hh"
 
 class G4Event;
+class HepMCEventIndex;
 
 class HepMCGenerator : public GeneratorBase 
 {
@@ -20,12 +27,31 @@ class HepMCGenerator : public GeneratorBase
     // override methods from common base class
     void LoadData() override;
     void GeneratePrimaries(G4Event* anEvent) override;
+    G4long GetNextEventIndex(const G4Event*) const override { return fEntries.Entry(fNGenerated); }
 
     // setter methods for messenger
     void SetHepMCFilename(G4String val) { fHepMCFilename = val; }
     void SetUseHepMC2(G4bool val) { fUseHepMC2 = val; }
     void SetHepMCVertexOffset(G4ThreeVector val) { fVtxOffset = val; }
     void SetPlaceInDecayVolume(G4bool val) { fPlaceInDecayVolume = val; }    
+    void SetInputFormat(G4String val) { fInputFormat = val; }
+    void SetFirstEvent(G4int val) { fFirstEvent = val; }
+    void SetNEvents(G4int val) { fNEvents = val; }
+    void SetEntryRange(G4int start, G4int count) override { fFirstEvent = start; fNEvents = count; }
+    void SetShard(G4int index, G4int nShards, G4bool strided) override { fShardIdx = index; fNShards = nShards; fShardStrided = strided; }
+    void SetPrefetchDepth(G4int val) { fPrefetchDepth = val; }
+
+    // getter methods for messenger
+    const G4String& GetHepMCFilename() const { return fHepMCFilename; }
+    G4bool GetUseHepMC2() const { return fUseHepMC2; }
+    const G4ThreeVector& GetHepMCVertexOffset() const { return fVtxOffset; }
+    G4bool GetPlaceInDecayVolume() const { return fPlaceInDecayVolume; }
+    const G4String& GetInputFormat() const { return fInputFormat; }
+    G4int GetFirstEvent() const { return fFirstEvent; }
+    G4int GetNEvents() const { return fNEvents; }
+    void GetEntryRange(G4int& start, G4int& count) const override { start = fFirstEvent; count = fNEvents; }
+    void GetShard(G4int& index, G4int& nShards, G4bool& strided) const override { index = fShardIdx; nShards = fNShards; strided = fShardStrided; }
+    G4int GetPrefetchDepth() const { return fPrefetchDepth; }
 
   private:
 
@@ -33,10 +59,38 @@ class HepMCGenerator : public GeneratorBase
     G4bool fUseHepMC2;
     G4bool fPlaceInDecayVolume;
     G4ThreeVector fVtxOffset;
-    HepMC3::Reader* fAsciiInput;
+    G4String fInputFormat; // auto, ascii, hepmc2, root, roottree
+    HepMC3::Reader* fHepMCInput;
+
+    // event selection: [fFirstEvent, fFirstEvent+fNEvents) split in shards
+    // plain ASCII files are seeked through the event index, other inputs skip events
+    G4int fFirstEvent;
+    G4int fNEvents;        // -1 for all
+    G4int fShardIdx;
+    G4int fNShards;
+    G4bool fShardStrided;
+    EntrySelection fEntries;
+    G4long fEventCounter;  // events read so far (by the reader thread in prefetch mode)
+    G4long fNGenerated;    // events passed to Geant4 so far
+    G4long fNextEntry;     // entry the input stream is positioned at
+    HepMCEventIndex* fEventIndex;
+    std::istream* fInputStream;
+
+    // prefetch mode: a reader thread parses up to fPrefetchDepth events ahead
+    // and hands them over, with their entry number, through fPrefetchQueue
+    using PrefetchedEvent = std::pair<G4long, std::shared_ptr<HepMC3::GenEvent>>;
+    G4int fPrefetchDepth;  // 0 to parse in GeneratePrimaries
+    BoundedQueue<PrefetchedEvent>* fPrefetchQueue;
+    std::thread fPrefetchThread;
         
     // specific internal functions
-    std::shared_ptr<HepMC3::GenEvent> GenerateHepMCEvent();
+    G4String ResolveInputFormat() const;
+    G4bool IsCompressedInput() const;
+    HepMC3::Reader* OpenReader(const G4String& format, G4bool compressed);
+    std::shared_ptr<HepMC3::GenEvent> ReadNextEvent(G4long& entry);
+    std::shared_ptr<HepMC3::GenEvent> GenerateHepMCEvent(G4long& entry);
+    void PrefetchLoop();
+    void StopPrefetch();
     G4bool CheckVertexInsideWorld (const G4ThreeVector& pos) const;
     void HepMC2G4(const std::shared_ptr<HepMC3::GenEvent> hepmcevt, G4Event* g4event);
     G4double GetStartOfDecayVolume();
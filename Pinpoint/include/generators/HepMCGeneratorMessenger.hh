@@ -11,6 +11,8 @@ class G4UIdirectory;
 class G4UIcmdWithAString;
 class G4UIcmdWith3VectorAndUnit;
 class G4UIcmdWithABool;
+class G4UIcmdWithAnInteger;
+class EntrySelectionCommands;
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -21,15 +23,21 @@ class HepMCGeneratorMessenger: public G4UImessenger
     ~HepMCGeneratorMessenger();
 
     void SetNewValue(G4UIcommand*, G4String);
+    G4String GetCurrentValue(G4UIcommand*);
     
   private:
     HepMCGenerator* fHepMCAction;
 
     G4UIdirectory* fHepMCGeneratorDir;
     G4UIcmdWithAString* fHepMCInputFileCmd;
+    G4UIcmdWithAString* fHepMCFormatCmd;
     G4UIcmdWith3VectorAndUnit* fHepMCVertexOffsetCmd;
     G4UIcmdWithABool* fUseHepMC2Cmd;
     G4UIcmdWithABool* fHepMCPlaceInDecayVolumeCmd;
+    G4UIcmdWithAnInteger* fHepMCFirstEventCmd;
+    G4UIcmdWithAnInteger* fHepMCNEventsCmd;
+    EntrySelectionCommands* fEntrySelectionCmds;
+    G4UIcmdWithAnInteger* fHepMCPrefetchCmd;
 
 };
 
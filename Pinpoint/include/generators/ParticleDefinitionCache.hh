@@ -0,0 +1,56 @@
+#ifndef ParticleDefinitionCache_HH
+#define ParticleDefinitionCache_HH
+
+#include <map>
+#include <unordered_map>
+
+#include "globals.hh"
+
+class G4ParticleDefinition;
+
+// PDG code -> G4ParticleDefinition lookup shared by all generators.
+// The cache is filled from the particle table on first use, ions are created
+// through the ion table once and then cached as well. Codes that cannot be
+// tracked (unknown codes, GENIE pseudo-particles) map to nullptr and are
+// counted instead of being reported for every particle.
+class ParticleDefinitionCache
+{
+  public:
+    // what to do with the GENIE pseudo-particles 2000000001-2000000202
+    enum class PseudoParticlePolicy { Skip, Geantino, ChargedGeantino };
+
+    static ParticleDefinitionCache* GetInstance();
+
+    // returns nullptr if the particle should not be passed to Geant4
+    G4ParticleDefinition* Find(G4int pdg);
+
+    void SetPseudoParticlePolicy(G4int pdg, PseudoParticlePolicy policy);
+    // every pseudo-particle, also those without a policy of their own
+    void SetPseudoParticlePolicy(PseudoParticlePolicy policy);
+    PseudoParticlePolicy GetPseudoParticlePolicy() const { return fDefaultPseudoParticlePolicy; }
+    // "skip", "geantino" or "chargedGeantino"
+    static PseudoParticlePolicy PolicyFromString(const G4String& name);
+    static G4String PolicyToString(PseudoParticlePolicy policy);
+
+    // number of skipped particles per PDG code since the last call to ResetSkipped
+    const std::map<G4int, G4long>& GetSkipped() const { return fSkipped; }
+    void PrintSkipped() const;
+    void ResetSkipped() { fSkipped.clear(); }
+
+  private:
+    ParticleDefinitionCache();
+    ~ParticleDefinitionCache() = default;
+
+    void Warm();
+    G4ParticleDefinition* Resolve(G4int pdg) const;
+
+    static ParticleDefinitionCache* fInstance;
+
+    G4bool fWarm;
+    std::unordered_map<G4int, G4ParticleDefinition*> fDefinitions;
+    std::map<G4int, PseudoParticlePolicy> fPseudoParticlePolicy;
+    PseudoParticlePolicy fDefaultPseudoParticlePolicy;
+    std::map<G4int, G4long> fSkipped;
+};
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef VertexSampler_HH
+#define VertexSampler_HH
+
+#include <vector>
+
+#include "CLHEP/Random/MixMaxRng.h"
+#include "G4AffineTransform.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+class G4LogicalVolume;
+class G4VPhysicalVolume;
+class G4VSolid;
+
+// Samples interaction vertices uniformly in the target volumes.
+// All placements of the targets in the world (replicas included) are found
+// once at construction and a CDF weighted by their mass (or volume) is built,
+// so each sample is a binary search plus a point in a box.
+// The sampler owns its random engine, reseeded from (master seed, seed, event key)
+// for every vertex: a vertex depends only on the input entry, not on the history
+// of the Geant4 engine, and the Geant4 engine is never touched.
+class VertexSampler
+{
+  public:
+    enum class Weighting { Mass, Volume };
+
+    VertexSampler(const std::vector<G4VPhysicalVolume*>& targets, Weighting weighting, G4long seed);
+    ~VertexSampler() = default;
+
+    // vertex in global coordinates for the event identified by key
+    G4ThreeVector Sample(G4long key);
+
+    std::size_t GetNInstances() const { return fInstances.size(); }
+    G4double GetTotalWeight() const { return fCDF.empty() ? 0. : fCDF.back(); }
+
+  private:
+    struct Instance {
+      G4AffineTransform toGlobal;
+      const G4VSolid* solid;
+      G4bool isBox;
+      G4ThreeVector boxMin;   // bounding box in local coordinates
+      G4ThreeVector boxMax;
+    };
+
+    void Collect(const G4LogicalVolume* mother, const G4AffineTransform& motherToGlobal,
+                 const std::vector<G4VPhysicalVolume*>& targets, Weighting weighting);
+    void AddInstance(const G4VPhysicalVolume* pv, const G4AffineTransform& toGlobal, Weighting weighting);
+
+    std::vector<Instance> fInstances;
+    std::vector<G4double> fCDF;
+    G4long fSeed;
+    CLHEP::MixMaxRng fEngine;
+};
+
+#endif
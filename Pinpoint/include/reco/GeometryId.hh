@@ -0,0 +1,99 @@
+// This file is part of the ACTS project.
+//
+// Copyright (C) 2016 CERN for the benefit of the ACTS project
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include "reco/MultiIndex.hh"
+
+#include <cstdint>
+
+/// Bit-compatible copy of Acts::GeometryIdentifier.
+///
+/// The levels are laid out as in ACTS (from the most significant bit):
+///
+///     volume(8) | boundary(8) | layer(12) | approach(8) | sensitive(20) | extra(8)
+///
+/// so that the encoded value can be used directly as `geometry_id` in
+/// ACTS-format simhit files.
+class GeometryId : public Acts::MultiIndex<std::uint64_t, 8, 8, 12, 8, 20, 8> {
+  using Base = Acts::MultiIndex<std::uint64_t, 8, 8, 12, 8, 20, 8>;
+
+ public:
+  using Base::Base;
+  using Base::Value;
+
+  // Construct an invalid GeometryId with all levels set to zero.
+  constexpr GeometryId() : Base(Base::Zeros()) {}
+  GeometryId(const GeometryId&) = default;
+  GeometryId(GeometryId&&) = default;
+  GeometryId& operator=(const GeometryId&) = default;
+  GeometryId& operator=(GeometryId&&) = default;
+
+  /// Return the volume identifier.
+  constexpr Value volume() const { return level(0); }
+  /// Return the boundary identifier.
+  constexpr Value boundary() const { return level(1); }
+  /// Return the layer identifier.
+  constexpr Value layer() const { return level(2); }
+  /// Return the approach identifier.
+  constexpr Value approach() const { return level(3); }
+  /// Return the sensitive identifier.
+  constexpr Value sensitive() const { return level(4); }
+
+  /// Set the volume identifier.
+  constexpr GeometryId& setVolume(Value id) {
+    set(0, id);
+    return *this;
+  }
+  /// Set the boundary identifier.
+  constexpr GeometryId& setBoundary(Value id) {
+    set(1, id);
+    return *this;
+  }
+  /// Set the layer identifier.
+  constexpr GeometryId& setLayer(Value id) {
+    set(2, id);
+    return *this;
+  }
+  /// Set the approach identifier.
+  constexpr GeometryId& setApproach(Value id) {
+    set(3, id);
+    return *this;
+  }
+  /// Set the sensitive identifier.
+  constexpr GeometryId& setSensitive(Value id) {
+    set(4, id);
+    return *this;
+  }
+
+  /// Geometry id of the sensitive silicon plane of a Pinpoint layer.
+  ///
+  /// Pinpoint has a single tracking volume and one sensitive surface per
+  /// layer; ACTS numbers layers with even values (odd values are navigation
+  /// layers) and counts from one.
+  static constexpr GeometryId PixelPlane(Value layerID) {
+    return GeometryId().setVolume(1).setLayer(2 * (layerID + 1)).setSensitive(1);
+  }
+
+  friend inline std::ostream& operator<<(std::ostream& os, GeometryId id) {
+    os << "vol=" << id.volume() << "|bnd=" << id.boundary()
+       << "|lay=" << id.layer() << "|apr=" << id.approach()
+       << "|sen=" << id.sensitive();
+    return os;
+  }
+};
+
+// specialize std::hash so GeometryId can be used e.g. in an unordered_map
+namespace std {
+template <>
+struct hash<GeometryId> {
+  auto operator()(GeometryId id) const noexcept {
+    return std::hash<GeometryId::Value>()(id.value());
+  }
+};
+}  // namespace std
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "PixelGeometry.hh"
+#include "PixelHit.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// Spatial index over the pixel hits of an event.
+///
+/// The hits of every layer are bucketed on a grid of bucketSize x bucketSize
+/// pixels in (row, col). The index is built once per event in O(n), with a
+/// counting sort into the occupied buckets only, and then answers
+/// - range queries: hits within a square window of +-R pixels
+/// - nearest-hit lookups in a layer
+/// - per-layer and per-module hit counts, for a configurable module size
+/// Hits are referred to by their position in the input, e.g. the index in the
+/// PixelHitsCollection.
+class HitIndex {
+ public:
+  /// @param bucketSize grid cell in pixels, ideally the typical query radius
+  explicit HitIndex(int bucketSize = 16) : fBucketSize(bucketSize > 0 ? bucketSize : 1) {}
+
+  void SetBucketSize(int bucketSize) { fBucketSize = bucketSize > 0 ? bucketSize : 1; }
+  /// module size in pixels; 0 disables the module counts
+  void SetModuleSize(int rows, int cols) { fModuleRows = rows; fModuleCols = cols; }
+
+  void Clear();
+  void AddHit(int layer, int row, int col);
+  void Build();
+  /// Clear, add every hit of the collection and build
+  void Build(const PixelHitsCollection& hits);
+
+  std::size_t size() const { return fLayer.size(); }
+  int GetLayer(int hit) const { return fLayer[hit]; }
+  int GetRow(int hit) const { return fRow[hit]; }
+  int GetCol(int hit) const { return fCol[hit]; }
+
+  /// Call f(hit) for every hit of the layer with |row - r| <= radius and
+  /// |col - c| <= radius
+  template <class F>
+  void ForEachInRange(int layer, int row, int col, int radius, F&& f) const;
+  void InRange(int layer, int row, int col, int radius, std::vector<int>& hits) const;
+  std::size_t CountInRange(int layer, int row, int col, int radius) const;
+
+  /// Hit of the layer closest to (row, col), -1 if there is none within
+  /// maxDistance pixels
+  int Nearest(int layer, double row, double col,
+              double maxDistance = std::numeric_limits<double>::max()) const;
+  /// Same, among the hits for which accept(hit) is true
+  template <class F>
+  int Nearest(int layer, double row, double col, double maxDistance, F&& accept) const;
+
+  int LayerCount(int layer) const;
+  /// number of hits in module (moduleRow, moduleCol) of the layer
+  int ModuleCount(int layer, int moduleRow, int moduleCol) const;
+  /// call f(layer, moduleRow, moduleCol, count) for every module with hits
+  template <class F>
+  void ForEachModule(F&& f) const;
+
+ private:
+  static constexpr int kBias = 1 << 20;   // allows negative indices
+
+  static std::uint64_t Key(int layer, int a, int b) { return PixelGeometry::Key(layer, a + kBias, b + kBias); }
+  static int FloorDiv(int a, int b) { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+
+  struct Bucket {
+    std::uint32_t first = 0;
+    std::uint32_t n = 0;
+  };
+  struct LayerBounds {
+    int count = 0;
+    int rowMin, rowMax, colMin, colMax;   // in buckets
+  };
+
+  const Bucket* FindBucket(int layer, int bucketRow, int bucketCol) const {
+    auto it = fBuckets.find(Key(layer, bucketRow, bucketCol));
+    return it == fBuckets.end() ? nullptr : &it->second;
+  }
+
+  int fBucketSize;
+  int fModuleRows = 0;
+  int fModuleCols = 0;
+
+  std::vector<int> fLayer, fRow, fCol;
+  std::vector<std::uint64_t> fHitBucket;
+  std::unordered_map<std::uint64_t, Bucket> fBuckets;
+  std::vector<int> fSorted;                            // hits grouped by bucket
+  std::unordered_map<int, LayerBounds> fLayers;
+  std::unordered_map<std::uint64_t, int> fModules;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+template <class F>
+void HitIndex::ForEachInRange(int layer, int row, int col, int radius, F&& f) const
+{
+  const int b0 = FloorDiv(row - radius, fBucketSize), b1 = FloorDiv(row + radius, fBucketSize);
+  const int c0 = FloorDiv(col - radius, fBucketSize), c1 = FloorDiv(col + radius, fBucketSize);
+  for (int br = b0; br <= b1; ++br) {
+    for (int bc = c0; bc <= c1; ++bc) {
+      const Bucket* bucket = FindBucket(layer, br, bc);
+      if (!bucket) continue;
+      for (std::uint32_t k = bucket->first; k < bucket->first + bucket->n; ++k) {
+        const int hit = fSorted[k];
+        if (fRow[hit] - row <= radius && row - fRow[hit] <= radius &&
+            fCol[hit] - col <= radius && col - fCol[hit] <= radius) f(hit);
+      }
+    }
+  }
+}
+
+template <class F>
+int HitIndex::Nearest(int layer, double row, double col, double maxDistance, F&& accept) const
+{
+  auto layerIt = fLayers.find(layer);
+  if (layerIt == fLayers.end()) return -1;
+  const LayerBounds& bounds = layerIt->second;
+
+  const int br = static_cast<int>(std::floor(row / fBucketSize));
+  const int bc = static_cast<int>(std::floor(col / fBucketSize));
+  // rings beyond this one are outside the occupied part of the layer
+  const int maxRing = std::max({br - bounds.rowMin, bounds.rowMax - br, bc - bounds.colMin, bounds.colMax - bc});
+
+  int best = -1;
+  double best2 = maxDistance < std::numeric_limits<double>::max() ? maxDistance * maxDistance
+                                                                  : std::numeric_limits<double>::max();
+  auto visit = [&](int r, int c) {
+    const Bucket* bucket = FindBucket(layer, r, c);
+    if (!bucket) return;
+    for (std::uint32_t k = bucket->first; k < bucket->first + bucket->n; ++k) {
+      const int hit = fSorted[k];
+      if (!accept(hit)) continue;
+      const double dr = fRow[hit] - row, dc = fCol[hit] - col;
+      const double d2 = dr * dr + dc * dc;
+      if (d2 <= best2) {
+        best2 = d2;
+        best = hit;
+      }
+    }
+  };
+
+  for (int ring = 0; ring <= maxRing; ++ring) {
+    // every hit in this ring is further than (ring - 1) buckets
+    const double reach = std::max(0, ring - 1) * static_cast<double>(fBucketSize);
+    if (reach * reach > best2) break;
+    if (ring == 0) {
+      visit(br, bc);
+      continue;
+    }
+    for (int c = bc - ring; c <= bc + ring; ++c) {
+      visit(br - ring, c);
+      visit(br + ring, c);
+    }
+    for (int r = br - ring + 1; r <= br + ring - 1; ++r) {
+      visit(r, bc - ring);
+      visit(r, bc + ring);
+    }
+  }
+  return best;
+}
+
+template <class F>
+void HitIndex::ForEachModule(F&& f) const
+{
+  for (const auto& [key, count] : fModules) {
+    f(PixelGeometry::KeyLayer(key), PixelGeometry::KeyRow(key) - kBias, PixelGeometry::KeyCol(key) - kBias, count);
+  }
+}
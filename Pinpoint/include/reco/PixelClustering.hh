@@ -0,0 +1,65 @@
+#pragma once
+
+#include "PixelGeometry.hh"
+
+#include <cstdint>
+#include <vector>
+
+/// Connected-component clustering of the fired pixels of an event.
+///
+/// Hits are added one by one, then sorted by channel (layer, row, column) and
+/// neighbouring pixels of the same layer are joined with a union-find pass;
+/// pixels sharing an edge (4-connectivity) or also a corner (8-connectivity)
+/// end up in the same cluster. Several hits on one pixel, e.g. from different
+/// tracks, count as one pixel of the cluster. The work arrays are kept between
+/// events.
+class PixelClustering {
+ public:
+  struct Cluster {
+    int layer = -1;
+    int size = 0;           ///< number of distinct pixels
+    double weight = 0.;     ///< sum of the hit weights
+    double row = 0.;        ///< weighted centroid, in pixel indices
+    double col = 0.;
+    int rowMin = 0, rowMax = 0;
+    int colMin = 0, colMax = 0;
+  };
+
+  /// @param connectivity 4 or 8
+  explicit PixelClustering(int connectivity = 8) { SetConnectivity(connectivity); }
+
+  void SetConnectivity(int connectivity) { fDiagonal = (connectivity == 8); }
+  int GetConnectivity() const { return fDiagonal ? 8 : 4; }
+
+  void Clear();
+  void AddHit(int layer, int row, int col, double weight);
+
+  /// Build the clusters of the hits added since the last Clear(), ordered by
+  /// layer and then by their first pixel.
+  const std::vector<Cluster>& Run();
+
+  const std::vector<Cluster>& GetClusters() const { return fClusters; }
+  /// cluster index of every hit, in the order they were added
+  const std::vector<int>& GetHitClusters() const { return fHitCluster; }
+
+ private:
+  static std::uint64_t Key(int layer, int row, int col) { return PixelGeometry::Key(layer, row, col); }
+
+  int Find(int i);
+  void Union(int a, int b);
+
+  bool fDiagonal = true;
+
+  // hits
+  std::vector<int> fLayer, fRow, fCol;
+  std::vector<double> fWeight;
+  // distinct pixels sorted by key, and the pixel of every hit
+  std::vector<std::pair<std::uint64_t, int>> fOrder;
+  std::vector<std::uint64_t> fPixelKey;
+  std::vector<int> fHitPixel;
+  std::vector<int> fParent;
+
+  std::vector<int> fPixelCluster;
+  std::vector<int> fHitCluster;
+  std::vector<Cluster> fClusters;
+};
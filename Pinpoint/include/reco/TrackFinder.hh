@@ -0,0 +1,96 @@
+#pragma once
+
+#include "PixelGeometry.hh"
+#include "reco/HitIndex.hh"
+
+#include <vector>
+
+/// Straight-line track finder for penetrating tracks (primary muons and
+/// leptons) in the pixel layers.
+///
+/// Combinatorial seeding in layer order: every unused isolated hit (at most
+/// maxNeighbours hits within +-isolation pixels, itself included, which keeps
+/// seeds out of shower cores) is paired with the isolated hits of the next
+/// layer within the slope window. The pair must be confirmed by a hit in one
+/// of the two following layers, and the seed is then followed through the
+/// detector in both directions with a running straight-line fit,
+/// taking the hit nearest to the prediction in every layer, until maxMissing
+/// consecutive layers have none. Candidates with at least minHits hits and a
+/// chi2/ndf below maxChi2 are kept, and their hits are not used for further
+/// seeds.
+/// All neighbourhood searches go through the HitIndex of the event, and at most
+/// maxSeeds seeds are followed per event, which bounds the time spent on
+/// pathological events.
+class TrackFinder {
+ public:
+  struct Track {
+    double x0 = 0., y0 = 0.;    ///< position at z = 0 [mm]
+    double tx = 0., ty = 0.;    ///< slopes dx/dz, dy/dz
+    double chi2 = 0.;           ///< for a pixel resolution of pitch/sqrt(12)
+    int ndf = 0;
+    int firstLayer = -1, lastLayer = -1;
+    std::vector<int> hits;      ///< HitIndex indices, in layer order
+  };
+
+  void SetMinHits(int n) { fMinHits = n; }
+  void SetMaxSlope(double slope) { fMaxSlope = slope; }
+  void SetTolerance(double tolerance) { fTolerance = tolerance; }
+  void SetMaxMissing(int n) { fMaxMissing = n; }
+  void SetMaxTracks(int n) { fMaxTracks = n; }
+  void SetMaxChi2(double chi2) { fMaxChi2 = chi2; }
+  void SetIsolation(int pixels, int maxNeighbours) { fIsolation = pixels; fMaxNeighbours = maxNeighbours; }
+  void SetMaxSeeds(int n) { fMaxSeeds = n; }
+
+  int GetMinHits() const { return fMinHits; }
+  double GetMaxSlope() const { return fMaxSlope; }
+  double GetTolerance() const { return fTolerance; }
+  int GetMaxMissing() const { return fMaxMissing; }
+  int GetMaxTracks() const { return fMaxTracks; }
+  double GetMaxChi2() const { return fMaxChi2; }
+  int GetIsolation() const { return fIsolation; }
+  int GetMaxNeighbours() const { return fMaxNeighbours; }
+  int GetMaxSeeds() const { return fMaxSeeds; }
+
+  const std::vector<Track>& Find(const HitIndex& index, const PixelGeometry& geometry);
+  const std::vector<Track>& GetTracks() const { return fTracks; }
+
+ private:
+  // least-squares line x(z), y(z) from running sums
+  struct LineFit {
+    double n = 0., sz = 0., szz = 0., sx = 0., szx = 0., sy = 0., szy = 0.;
+    void Add(double z, double x, double y) {
+      n += 1.; sz += z; szz += z * z; sx += x; szx += z * x; sy += y; szy += z * y;
+    }
+    void Solve(double& x0, double& tx, double& y0, double& ty) const {
+      const double det = n * szz - sz * sz;
+      tx = (n * szx - sz * sx) / det;
+      ty = (n * szy - sz * sy) / det;
+      x0 = (sx - tx * sz) / n;
+      y0 = (sy - ty * sz) / n;
+    }
+  };
+
+  // hit of the layer nearest to the line of the fit, -1 if beyond the tolerance
+  int Follow(const HitIndex& index, const PixelGeometry& geometry, const LineFit& fit, int layer) const;
+  bool IsIsolated(const HitIndex& index, int hit);
+  // adds the hits found going from layer start in direction step
+  void Extend(const HitIndex& index, const PixelGeometry& geometry, LineFit& fit, int start, int step);
+
+  int fMinHits = 8;
+  double fMaxSlope = 0.3;
+  double fTolerance = 0.1;    // [mm]
+  int fMaxMissing = 2;
+  int fMaxTracks = 50;
+  double fMaxChi2 = 3.;       // per degree of freedom
+  int fIsolation = 10;        // [pixels]
+  int fMaxNeighbours = 5;
+  int fMaxSeeds = 100000;
+
+  // per event work arrays
+  std::vector<double> fX, fY, fZ;
+  std::vector<char> fUsed;
+  std::vector<char> fIsolated;  // 0: not checked yet, 1: isolated, 2: not isolated
+  std::vector<int> fLayerFirst, fLayerHits;   // hits grouped by layer
+  std::vector<int> fCandidate, fPartners;
+  std::vector<Track> fTracks;
+};
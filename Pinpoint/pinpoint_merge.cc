@@ -0,0 +1,428 @@
+/* pinpoint_merge: combine the output files of several pinpoint jobs, shards
+ * or threads into one file.
+ *
+ * Unlike hadd it knows the output schema:
+ * - events are identified by their sample and evtID (event_id in Hits/), the
+ *   index of the event in the sample; the output is sorted by both
+ * - the sample of an input is given by the master seed and generator input
+ *   recorded in its run tree, so different input files or seeds never clash
+ * - events present in several inputs of one sample (resumed jobs) are kept
+ *   only once, from the first input that contains them
+ * - every input must have its run tree, which is only written by jobs that
+ *   finished, and the geometry recorded there must be the same in all of them
+ * The occupancy histograms (Occupancy/) of all inputs are added up.
+ * Inputs whose events all go to the output in one block are cloned basket by
+ * basket without decompression; only the others are copied entry by entry.
+ * The inputs are indexed in parallel and ROOT implicit multi-threading is
+ * used to (de)compress the copied entries.
+ */
+
+#include <TFile.h>
+#include <TTree.h>
+#include <TLeaf.h>
+#include <TDirectory.h>
+#include <TH1.h>
+#include <THnBase.h>
+#include <TKey.h>
+#include <TROOT.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+// output trees and the branch identifying their event
+struct TreeSpec {
+  const char* path;
+  const char* idBranch;
+};
+const std::vector<TreeSpec> kTrees = {
+  {"event", "evtID"},
+  {"primaries", "evtID"},
+  {"trajectories", "evtID"},
+  {"Hits/pixelHits", "event_id"},
+  {"Hits/pixelDigits", "event_id"},
+  {"Hits/clusters", "event_id"},
+  {"Hits/summary", "event_id"},
+  {"Hits/tracks", "event_id"},
+  {"Hits/particles", "event_id"},
+  {"Hits/hits", "event_id"},
+};
+const char* kRunTree = "run";
+// run tree settings that, with the master seed, identify the generated sample
+const std::vector<std::string> kSampleSettings = {"/gen/select", "/gen/hepmc/hepmcInput", "/gen/genie/genieInput", "/gen/gfaser/input"};
+const char* kOccupancyDir = "Occupancy";
+
+// entries [first, first + n) of a tree belong to one event
+struct EntryRange {
+  Long64_t first;
+  Long64_t n;
+};
+
+struct InputFile {
+  std::string name;
+  std::vector<Long64_t> events;                         // evtID in file order
+  std::vector<std::map<Long64_t, EntryRange>> ranges;   // per kTrees entry
+  std::vector<bool> hasTree;                            // per kTrees entry
+  bool hasRun = false;                                  // written at the end of the job
+  std::string geometryHash;
+  std::string sample;                                   // seed and generator input
+  std::size_t sampleIndex = 0;
+  std::string error;
+};
+
+// reads only the event id branch of every tree
+void IndexFile(InputFile& input)
+{
+  input.ranges.resize(kTrees.size());
+  input.hasTree.assign(kTrees.size(), false);
+
+  std::unique_ptr<TFile> file(TFile::Open(input.name.c_str(), "READ"));
+  if (!file || file->IsZombie()) {
+    input.error = "cannot open file";
+    return;
+  }
+
+  for (std::size_t t = 0; t < kTrees.size(); ++t) {
+    auto tree = file->Get<TTree>(kTrees[t].path);
+    if (!tree) continue;
+    TLeaf* leaf = tree->GetLeaf(kTrees[t].idBranch);
+    if (!leaf) {
+      input.error = std::string("tree ") + kTrees[t].path + " has no " + kTrees[t].idBranch + " branch";
+      return;
+    }
+    input.hasTree[t] = true;
+
+    tree->SetBranchStatus("*", false);
+    tree->SetBranchStatus(kTrees[t].idBranch, true);
+    auto& ranges = input.ranges[t];
+    Long64_t current = -1;
+    for (Long64_t entry = 0; entry < tree->GetEntries(); ++entry) {
+      leaf->GetBranch()->GetEntry(entry);
+      Long64_t id = leaf->GetValueLong64();
+      if (entry > 0 && id == current) {
+        ranges[id].n++;
+        continue;
+      }
+      if (ranges.count(id)) {
+        input.error = std::string("entries of event ") + std::to_string(id) + " are not contiguous in " + kTrees[t].path;
+        return;
+      }
+      ranges[id] = {entry, 1};
+      current = id;
+      if (t == 0) input.events.push_back(id);
+    }
+  }
+  if (!input.hasTree[0]) input.error = "no event tree";
+
+  if (auto run = file->Get<TTree>(kRunTree)) {
+    input.hasRun = true;
+    std::string* hash = nullptr;
+    std::vector<std::string>* settingName = nullptr;
+    std::vector<std::string>* settingValue = nullptr;
+    Long64_t masterSeed = 0;
+    bool hasSettings = run->GetBranch("settingName") && run->GetBranch("settingValue") && run->GetBranch("masterSeed");
+    if (run->GetBranch("det_geometryHash")) run->SetBranchAddress("det_geometryHash", &hash);
+    if (hasSettings) {
+      run->SetBranchAddress("settingName", &settingName);
+      run->SetBranchAddress("settingValue", &settingValue);
+      run->SetBranchAddress("masterSeed", &masterSeed);
+    }
+    // a merged input has one run entry per job, possibly of several samples
+    std::set<std::string> samples;
+    for (Long64_t entry = 0; entry < run->GetEntries(); ++entry) {
+      if (run->GetEntry(entry) <= 0) continue;
+      if (entry == 0 && hash) input.geometryHash = *hash;
+      if (!hasSettings || !settingName || !settingValue) continue;
+      std::ostringstream sample;
+      sample << "masterSeed " << masterSeed;
+      for (const auto& setting : kSampleSettings) {
+        for (std::size_t i = 0; i < settingName->size() && i < settingValue->size(); ++i) {
+          if ((*settingName)[i] == setting) sample << "; " << setting << " " << (*settingValue)[i];
+        }
+      }
+      samples.insert(sample.str());
+    }
+    for (const auto& sample : samples) input.sample += (input.sample.empty() ? "" : " | ") + sample;
+    run->ResetBranchAddresses();
+    delete hash;
+    delete settingName;
+    delete settingValue;
+  }
+}
+
+// consecutive output events taken from one input
+struct Segment {
+  std::size_t input;
+  std::vector<Long64_t> events;
+  bool wholeFile;
+};
+
+void PrintUsage()
+{
+  std::cout << "Usage: pinpoint_merge [-j threads] [-f] output.root input1.root [input2.root ...]\n"
+            << "  -j <n>  threads used to read the inputs (default: hardware concurrency)\n"
+            << "  -f      merge even if inputs are unfinished or their geometries differ\n";
+}
+
+// points the branches of out to the buffers of in (nullptr: to none);
+// current is the input tree out is connected to
+void ConnectAddresses(TTree*& current, TTree* in, TTree* out)
+{
+  if (current == in) return;
+  if (current) current->CopyAddresses(out, true);
+  if (in) in->CopyAddresses(out);
+  current = in;
+}
+
+// entry-by-entry copy of the given events of one input tree, whose addresses
+// out must be connected to
+void CopyEvents(TTree* in, TTree* out, const std::map<Long64_t, EntryRange>& ranges, const std::vector<Long64_t>& events)
+{
+  for (Long64_t id : events) {
+    auto range = ranges.find(id);
+    if (range == ranges.end()) continue;
+    for (Long64_t entry = range->second.first; entry < range->second.first + range->second.n; ++entry) {
+      in->GetEntry(entry);
+      out->Fill();
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+  unsigned nThreads = std::max(1u, std::thread::hardware_concurrency());
+  bool force = false;
+  std::vector<std::string> files;
+  for (int i = 1; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (arg == "-j" && i + 1 < argc) nThreads = std::max(1, std::atoi(argv[++i]));
+    else if (arg == "-f") force = true;
+    else if (arg == "-h" || arg == "--help") { PrintUsage(); return EXIT_SUCCESS; }
+    else files.push_back(arg);
+  }
+  if (files.size() < 2) {
+    PrintUsage();
+    return EXIT_FAILURE;
+  }
+  const std::string outputName = files.front();
+  std::vector<InputFile> inputs(files.size() - 1);
+  for (std::size_t i = 0; i < inputs.size(); ++i) inputs[i].name = files[i + 1];
+
+  //------------------------------------------------
+  // index the inputs in parallel
+  ROOT::EnableThreadSafety();
+  {
+    std::atomic<std::size_t> next(0);
+    std::vector<std::thread> workers;
+    for (unsigned w = 0; w < std::min<std::size_t>(nThreads, inputs.size()); ++w) {
+      workers.emplace_back([&] {
+        for (std::size_t i = next++; i < inputs.size(); i = next++) IndexFile(inputs[i]);
+      });
+    }
+    for (auto& worker : workers) worker.join();
+  }
+  for (const auto& input : inputs) {
+    if (!input.error.empty()) {
+      std::cerr << "pinpoint_merge: " << input.name << ": " << input.error << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  //------------------------------------------------
+  // only finished jobs, all describing the same detector
+  for (const auto& input : inputs) {
+    if (input.hasRun) continue;
+    std::cerr << "pinpoint_merge: " << input.name << " has no run tree, the job did not finish" << std::endl;
+    if (!force) return EXIT_FAILURE;
+  }
+  const std::string& geometry = inputs.front().geometryHash;
+  for (const auto& input : inputs) {
+    if (input.geometryHash == geometry) continue;
+    std::cerr << "pinpoint_merge: geometry of " << input.name << " (" << (input.geometryHash.empty() ? "unknown" : input.geometryHash)
+              << ") differs from " << inputs.front().name << " (" << (geometry.empty() ? "unknown" : geometry) << ")" << std::endl;
+    if (!force) return EXIT_FAILURE;
+  }
+
+  //------------------------------------------------
+  // samples, numbered in input order; inputs without settings (e.g. of older
+  // versions) share one unknown sample
+  std::map<std::string, std::size_t> sampleIndices;
+  for (auto& input : inputs) {
+    auto inserted = sampleIndices.emplace(input.sample, sampleIndices.size());
+    input.sampleIndex = inserted.first->second;
+  }
+  if (sampleIndices.size() > 1) {
+    std::cout << "pinpoint_merge: " << sampleIndices.size() << " samples, events are only deduplicated within a sample" << std::endl;
+  }
+
+  //------------------------------------------------
+  // keep every event of a sample once, from the first input holding it, in
+  // (sample, evtID) order
+  std::vector<std::size_t> order(inputs.size());
+  for (std::size_t i = 0; i < order.size(); ++i) order[i] = i;
+  std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+    Long64_t firstA = inputs[a].events.empty() ? 0 : inputs[a].events.front();
+    Long64_t firstB = inputs[b].events.empty() ? 0 : inputs[b].events.front();
+    return std::tie(inputs[a].sampleIndex, firstA) < std::tie(inputs[b].sampleIndex, firstB);
+  });
+
+  std::vector<std::tuple<std::size_t, Long64_t, std::size_t>> kept; // (sample, evtID, input)
+  std::vector<std::size_t> nKept(inputs.size(), 0);
+  std::set<std::pair<std::size_t, Long64_t>> seen; // (sample, evtID)
+  Long64_t nEventsIn = 0;
+  for (std::size_t i : order) {
+    nEventsIn += inputs[i].events.size();
+    for (Long64_t id : inputs[i].events) {
+      if (!seen.emplace(inputs[i].sampleIndex, id).second) continue;
+      kept.emplace_back(inputs[i].sampleIndex, id, i);
+      nKept[i]++;
+    }
+  }
+  std::stable_sort(kept.begin(), kept.end());
+
+  std::vector<Segment> segments;
+  for (const auto& [sample, id, input] : kept) {
+    if (segments.empty() || segments.back().input != input) segments.push_back({input, {}, false});
+    segments.back().events.push_back(id);
+  }
+  for (auto& segment : segments) {
+    segment.wholeFile = (segment.events.size() == inputs[segment.input].events.size());
+  }
+
+  //------------------------------------------------
+  // copy
+  ROOT::EnableImplicitMT(nThreads);
+
+  std::unique_ptr<TFile> output(TFile::Open(outputName.c_str(), "RECREATE"));
+  if (!output || output->IsZombie()) {
+    std::cerr << "pinpoint_merge: cannot create " << outputName << std::endl;
+    return EXIT_FAILURE;
+  }
+  TDirectory* hitsDir = output->mkdir("Hits", "Hits output", kTRUE);
+
+  std::vector<TTree*> outTrees(kTrees.size(), nullptr);
+  TTree* outRun = nullptr;
+  std::size_t nFast = 0, nSlow = 0;
+
+  // the run trees of all inputs are kept, in input order
+  for (const auto& input : inputs) {
+    std::unique_ptr<TFile> file(TFile::Open(input.name.c_str(), "READ"));
+    auto run = file->Get<TTree>(kRunTree);
+    if (!run) continue;
+    if (!outRun) {
+      output->cd();
+      outRun = run->CloneTree(0);
+    }
+    outRun->CopyEntries(run, -1, "fast");
+  }
+
+  // occupancy histograms are summed over all inputs, duplicates included:
+  // they are filled per job and cannot be split by event
+  TDirectory* outOccupancy = nullptr;
+  std::map<std::string, TObject*> occupancy;
+  for (const auto& input : inputs) {
+    std::unique_ptr<TFile> file(TFile::Open(input.name.c_str(), "READ"));
+    auto dir = file->Get<TDirectory>(kOccupancyDir);
+    if (!dir) continue;
+    if (!outOccupancy) outOccupancy = output->mkdir(kOccupancyDir, "Occupancy histograms", kTRUE);
+    for (auto key : *dir->GetListOfKeys()) {
+      std::unique_ptr<TObject> obj(static_cast<TKey*>(key)->ReadObj());
+      auto& merged = occupancy[obj->GetName()];
+      if (auto hist = dynamic_cast<TH1*>(obj.get())) {
+        if (merged) static_cast<TH1*>(merged)->Add(hist);
+        else {
+          hist->SetDirectory(outOccupancy);
+          merged = obj.release();
+        }
+      }
+      else if (auto hist = dynamic_cast<THnBase*>(obj.get())) {
+        if (merged) static_cast<THnBase*>(merged)->Add(hist);
+        else merged = obj.release();
+      }
+    }
+  }
+
+  // every input and its trees are opened once: with strided shards the
+  // segments alternate between the inputs, down to one event each
+  std::vector<std::unique_ptr<TFile>> inFiles(inputs.size());
+  std::vector<std::vector<TTree*>> inTrees(inputs.size(), std::vector<TTree*>(kTrees.size(), nullptr));
+  for (std::size_t i = 0; i < inputs.size(); ++i) {
+    if (nKept[i] == 0) continue;
+    inFiles[i].reset(TFile::Open(inputs[i].name.c_str(), "READ"));
+    if (!inFiles[i] || inFiles[i]->IsZombie()) {
+      std::cerr << "pinpoint_merge: cannot open " << inputs[i].name << std::endl;
+      return EXIT_FAILURE;
+    }
+    for (std::size_t t = 0; t < kTrees.size(); ++t) {
+      if (inputs[i].hasTree[t]) inTrees[i][t] = inFiles[i]->Get<TTree>(kTrees[t].path);
+    }
+  }
+  // input tree the addresses of every output tree are connected to
+  std::vector<TTree*> connected(kTrees.size(), nullptr);
+
+  for (const auto& segment : segments) {
+    const InputFile& input = inputs[segment.input];
+
+    for (std::size_t t = 0; t < kTrees.size(); ++t) {
+      if (!input.hasTree[t]) continue;
+      TTree* in = inTrees[segment.input][t];
+      if (!outTrees[t]) {
+        (std::string(kTrees[t].path).rfind("Hits/", 0) == 0 ? hitsDir : static_cast<TDirectory*>(output.get()))->cd();
+        outTrees[t] = in->CloneTree(0);
+      }
+
+      if (segment.wholeFile) {
+        ConnectAddresses(connected[t], nullptr, outTrees[t]);
+        Long64_t before = outTrees[t]->GetEntries();
+        outTrees[t]->CopyEntries(in, -1, "fast");
+        if (outTrees[t]->GetEntries() - before == in->GetEntries()) continue;
+        // basket cloning refused (e.g. different streamer versions): copy
+        // the entries instead; nothing was added in that case
+        if (outTrees[t]->GetEntries() != before) {
+          std::cerr << "pinpoint_merge: partial fast copy of " << kTrees[t].path << " from " << input.name << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+      ConnectAddresses(connected[t], in, outTrees[t]);
+      CopyEvents(in, outTrees[t], input.ranges[t], segment.events);
+    }
+    (segment.wholeFile ? nFast : nSlow)++;
+  }
+  for (std::size_t t = 0; t < kTrees.size(); ++t) {
+    if (outTrees[t]) ConnectAddresses(connected[t], nullptr, outTrees[t]);
+  }
+  inFiles.clear();
+
+  //------------------------------------------------
+  output->cd();
+  if (outRun) outRun->Write();
+  for (std::size_t t = 0; t < kTrees.size(); ++t) {
+    if (!outTrees[t]) continue;
+    outTrees[t]->GetDirectory()->cd();
+    outTrees[t]->Write();
+  }
+  if (outOccupancy) {
+    outOccupancy->cd();
+    for (auto& [name, obj] : occupancy) if (obj) obj->Write();
+  }
+  output->Close();
+
+  std::cout << "pinpoint_merge: " << inputs.size() << " inputs, " << nEventsIn << " events read, "
+            << nEventsIn - static_cast<Long64_t>(kept.size()) << " duplicates dropped, "
+            << kept.size() << " events written to " << outputName << std::endl;
+  std::cout << "pinpoint_merge: " << nFast << " blocks cloned, " << nSlow << " blocks copied entry by entry" << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -6,6 +6,8 @@
 #include "TrackingAction.hh"
 #include "StackingAction.hh"
 #include "SteppingAction.hh"
+#include "PixelDigitizer.hh"
+#include "G4DigiManager.hh"
 
 void ActionInitialization::Build() const {
   SetUserAction(new PrimaryGeneratorAction());
@@ -16,6 +18,9 @@ void ActionInitialization::Build() const {
   SetUserAction(new TrackingAction);
   SetUserAction(new StackingAction(theRunAction, theEventAction));
   SetUserAction(new SteppingAction(theRunAction));
+
+  // disabled until /digi/enable
+  G4DigiManager::GetDMpointer()->AddNewModule(new PixelDigitizer("PixelDigitizer"));
 }
 
 void ActionInitialization::BuildForMaster() const {
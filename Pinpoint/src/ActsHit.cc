@@ -0,0 +1,21 @@
+#include "ActsHit.hh"
+#include "G4UnitsTable.hh"
+
+#include <iomanip>
+
+G4ThreadLocal G4Allocator<ActsHit>* ActsHitAllocator = nullptr;
+
+G4bool ActsHit::operator==(const ActsHit& right) const
+{
+  return ( this == &right ) ? true : false;
+}
+
+void ActsHit::Print()
+{
+  G4cout
+     << "  trackID: " << fTrackID
+     << "  layer: " << fLayerID
+     << "  Position: " << std::setw(7) << G4BestUnit(fX4.vect(), "Length")
+     << "  Edep: " << std::setw(7) << G4BestUnit(fEnergyDeposit, "Energy")
+     << G4endl;
+}
@@ -5,6 +5,7 @@
 #include <map>
 #include <iomanip>
 #include <random>
+#include <algorithm>
 
 #include <G4Event.hh>
 #include <G4SDManager.hh>
@@ -13,6 +14,11 @@
 #include <G4Poisson.hh>
 #include <G4Trajectory.hh>
 #include <G4LorentzVector.hh>
+#include <G4EventManager.hh>
+#include <G4RunManager.hh>
+#include <G4VProcess.hh>
+#include <G4DigiManager.hh>
+#include <G4DCofThisEvent.hh>
 #include "G4SDManager.hh"
 #include "G4THitsCollection.hh"
 #include "G4VVisManager.hh"
@@ -25,13 +31,88 @@
 #include <TH2F.h>
 #include <THnSparse.h>
 #include <TString.h>
+#include <TROOT.h>
 #include <Math/ProbFunc.h>
 
+#include <G4Version.hh>
+#include <G4Run.hh>
+#include <G4UImanager.hh>
+#include <G4UIcommandTree.hh>
+#include <G4UIcommand.hh>
+
+#include <ctime>
+#include <sys/resource.h>
+#include <sys/utsname.h>
+#include <thread>
+#include <unistd.h>
+
 #include "EventInformation.hh"
 #include "AnalysisManager.hh"
+#include "TrackFinderMessenger.hh"
+#include "DetectorConstruction.hh"
+#include "SeedService.hh"
+#include "StartupTimer.hh"
 #include "reco/Barcode.hh"
+#include "reco/GeometryId.hh"
 #include "FPFParticle.hh"
 #include "PixelHit.hh"
+#include "PixelSD.hh"
+#include "ActsHit.hh"
+#include "PixelDigi.hh"
+#include "PixelDigitizer.hh"
+
+#ifndef PINPOINT_VERSION
+#define PINPOINT_VERSION "unknown"
+#endif
+
+namespace {
+  // user + system CPU time of the process [s]
+  G4double ProcessCpuTime()
+  {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + 1e-6 * (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec);
+  }
+
+  // peak resident set size of the process [MB]
+  G4double PeakRSS()
+  {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1024.; // kB on Linux
+  }
+
+  // command prefixes whose settings are recorded in the run tree
+  const std::vector<std::string> kRecordedCommands = {"/det/", "/gen/", "/gps/", "/out/", "/random/", "/overlay/", "/digi/", "/reco/", "/run/physicsTableCache"};
+
+  G4bool IsRecorded(const std::string& path)
+  {
+    for (const auto& prefix : kRecordedCommands) {
+      if (path.rfind(prefix, 0) == 0) return true;
+    }
+    return false;
+  }
+
+  // current value of every recorded command below tree, as returned by its messenger
+  void CollectSettings(G4UIcommandTree* tree, std::map<std::string, std::string>& settings)
+  {
+    G4UImanager* ui = G4UImanager::GetUIpointer();
+    for (G4int i = 1; i <= tree->GetCommandEntry(); i++) {
+      std::string path = tree->GetCommand(i)->GetCommandPath();
+      if (IsRecorded(path)) settings[path] = ui->GetCurrentValues(path.c_str());
+    }
+    for (G4int i = 1; i <= tree->GetTreeEntry(); i++) {
+      G4UIcommandTree* subTree = tree->GetTree(i);
+      std::string path = subTree->GetPathName();
+      // directories holding recorded commands, e.g. /run/ for /run/physicsTableCache
+      G4bool relevant = false;
+      for (const auto& prefix : kRecordedCommands) {
+        if (path.rfind(prefix, 0) == 0 || prefix.rfind(path, 0) == 0) relevant = true;
+      }
+      if (relevant) CollectSettings(subTree, settings);
+    }
+  }
+}
 
 
 //---------------------------------------------------------------------
@@ -59,14 +140,37 @@ AnalysisManager::AnalysisManager()
   fFilename = "test.root";
 
   fMessenger = new AnalysisManagerMessenger(this);
+  fTrackFinderMessenger = new TrackFinderMessenger(this);
 
   fEvt = nullptr;
   fTrk = nullptr;
   fPrim = nullptr;
   fPixelHitsTree = nullptr;
-  // fActsParticlesTree = nullptr;
+  fPixelDigitsTree = nullptr;
+  fClustersTree = nullptr;
+  fSummaryTree = nullptr;
+  fTracksTree = nullptr;
+  fActsParticlesTree = nullptr;
+  fActsHitsTree = nullptr;
   
   fSaveTrack = false;
+  fSaveActs = false;
+  fSaveDigits = false;
+  fSaveClusters = false;
+  fSaveTruthLinks = false;
+  fSaveHitPositions = false;
+  fSummaryMode = false;
+  fFindTracks = false;
+  fSaveOccupancy = false;
+  fOccupancyRebin = 64;
+  fModuleWidth = 125 * mm;
+  fModuleHeight = 37.5 * mm;
+  fDropRawHits = false;
+
+  fPhysicsListName = "unknown";
+  fNEventsWritten = 0;
+  fRunStartWallTime = 0.;
+  fRunStartCpuTime = 0.;
 }
 
 AnalysisManager::~AnalysisManager() {}
@@ -77,7 +181,7 @@ AnalysisManager::~AnalysisManager() {}
 void AnalysisManager::bookEvtTree()
 {
   fEvt = new TTree("event", "event info");
-  fEvt->Branch("evtID", &evtID, "evtID/I");
+  fEvt->Branch("evtID", &evtID, "evtID/L");
   fEvt->Branch("vtxID", &vertexID, "vtxID/I");
   fEvt->Branch("weight", &weight, "weight/D");
   fEvt->Branch("genType", &genType);
@@ -110,7 +214,7 @@ void AnalysisManager::bookEvtTree()
 void AnalysisManager::bookPrimTree()
 {
   fPrim = new TTree("primaries", "primaries info");
-  fPrim->Branch("evtID", &evtID, "evtID/I");
+  fPrim->Branch("evtID", &evtID, "evtID/L");
   fPrim->Branch("vtxID", &primVtxID, "vtxID/I");
   fPrim->Branch("PDG", &primPDG, "PDG/I");
   fPrim->Branch("trackID", &primTrackID, "trackID/I");
@@ -135,7 +239,7 @@ void AnalysisManager::bookPrimTree()
 void AnalysisManager::bookTrkTree()
 {
   fTrk = new TTree("trajectories", "trajectories info");
-  fTrk->Branch("evtID", &evtID, "evtID/I");
+  fTrk->Branch("evtID", &evtID, "evtID/L");
   fTrk->Branch("trackTID", &trackTID, "trackTID/I");
   fTrk->Branch("trackPID", &trackPID, "trackPID/I");
   fTrk->Branch("trackPDG", &trackPDG, "trackPDG/I");
@@ -156,50 +260,159 @@ void AnalysisManager::bookHitsTrees()
   fFile->cd(fHits->GetName());
 
   //* Reco Hits Tree [i == unsigned int; F == float; l == Long unsigned 64 int]
-  fPixelHitsTree = new TTree("pixelHits", "pixelHits_Tree");
-  fPixelHitsTree->Branch("event_id", &fPixelEventID, "event_id/i");
-  fPixelHitsTree->Branch("hit_rowID", &fPixelRowIDs);
-  fPixelHitsTree->Branch("hit_colID", &fPixelColIDs);
-  fPixelHitsTree->Branch("hit_layerID", &fPixelLayerIDs);
-  fPixelHitsTree->Branch("hit_pdgc", &fPixelPDGCs);
-  fPixelHitsTree->Branch("hit_trackID", &fPixelTrackIDs);
-  // fPixelHitsTree->Branch("hit_parentID", &recoHitsParentID);
-  fPixelHitsTree->Branch("hit_px", &fPixelPxs);
-  fPixelHitsTree->Branch("hit_py", &fPixelPys);
-  fPixelHitsTree->Branch("hit_pz", &fPixelPzs);
-  fPixelHitsTree->Branch("hit_energy", &fPixelEnergies);
-  fPixelHitsTree->Branch("hit_charge", &fPixelCharges);
-
-
-  //* Acts truth particle tree
-  // fActsParticlesTree = new TTree("particles", "ActsParticlesTree");
-  // fActsParticlesTree->Branch("event_id", &recoHitsEventID, "event_id/i");
-  // fActsParticlesTree->Branch("particle_id", &ActsParticlesParticleId);
-  // fActsParticlesTree->Branch("particle_type", &ActsParticlesParticleType);
-  // fActsParticlesTree->Branch("process", &ActsParticlesProcess);
-  // fActsParticlesTree->Branch("vx", &ActsParticlesVx);
-  // fActsParticlesTree->Branch("vy", &ActsParticlesVy);
-  // fActsParticlesTree->Branch("vz", &ActsParticlesVz);
-  // fActsParticlesTree->Branch("vt", &ActsParticlesVt);
-  // fActsParticlesTree->Branch("px", &ActsParticlesPx);
-  // fActsParticlesTree->Branch("py", &ActsParticlesPy);
-  // fActsParticlesTree->Branch("pz", &ActsParticlesPz);
-  // fActsParticlesTree->Branch("m", &ActsParticlesM);
-  // fActsParticlesTree->Branch("q", &ActsParticlesQ);
-  // fActsParticlesTree->Branch("eta", &ActsParticlesEta);
-  // fActsParticlesTree->Branch("phi", &ActsParticlesPhi);
-  // fActsParticlesTree->Branch("pt", &ActsParticlesPt);
-  // fActsParticlesTree->Branch("p", &ActsParticlesP);
-  // fActsParticlesTree->Branch("vertex_primary", &ActsParticlesVertexPrimary);
-  // fActsParticlesTree->Branch("vertex_secondary", &ActsParticlesVertexSecondary);
-  // fActsParticlesTree->Branch("particle", &ActsParticlesParticle);
-  // fActsParticlesTree->Branch("generation", &ActsParticlesGeneration);
-  // fActsParticlesTree->Branch("sub_particle", &ActsParticlesSubParticle);
-  // fActsParticlesTree->Branch("e_loss", &ActsParticlesELoss);
-  // fActsParticlesTree->Branch("total_x0", &ActsParticlesPathInX0);
-  // fActsParticlesTree->Branch("total_l0", &ActsParticlesPathInL0);
-  // fActsParticlesTree->Branch("number_of_hits", &ActsParticlesNumberOfHits);
-  // fActsParticlesTree->Branch("outcome", &ActsParticlesOutcome);
+  if (!fDropRawHits) {
+    fPixelHitsTree = new TTree("pixelHits", "pixelHits_Tree");
+    fPixelHitsTree->Branch("event_id", &fPixelEventID, "event_id/l");
+    fPixelHitsTree->Branch("hit_rowID", &fPixelRowIDs);
+    fPixelHitsTree->Branch("hit_colID", &fPixelColIDs);
+    fPixelHitsTree->Branch("hit_layerID", &fPixelLayerIDs);
+    fPixelHitsTree->Branch("hit_pdgc", &fPixelPDGCs);
+    fPixelHitsTree->Branch("hit_trackID", &fPixelTrackIDs);
+    // fPixelHitsTree->Branch("hit_parentID", &recoHitsParentID);
+    fPixelHitsTree->Branch("hit_px", &fPixelPxs);
+    fPixelHitsTree->Branch("hit_py", &fPixelPys);
+    fPixelHitsTree->Branch("hit_pz", &fPixelPzs);
+    fPixelHitsTree->Branch("hit_energy", &fPixelEnergies);
+    fPixelHitsTree->Branch("hit_charge", &fPixelCharges);
+    if (fSaveClusters) fPixelHitsTree->Branch("hit_clusterID", &fPixelClusterIDs);
+    if (fSaveHitPositions) {
+      fPixelHitsTree->Branch("hit_x", &fPixelXs);
+      fPixelHitsTree->Branch("hit_y", &fPixelYs);
+      fPixelHitsTree->Branch("hit_z", &fPixelZs);
+    }
+    if (fSaveTruthLinks) {
+      // links of hit i: [hit_truthOffset[i], hit_truthOffset[i+1]), the last hit up to the end
+      fPixelHitsTree->Branch("hit_truthOffset", &fPixelTruthOffsets);
+      fPixelHitsTree->Branch("truth_trackID", &fTruthTrackIDs);
+      fPixelHitsTree->Branch("truth_fraction", &fTruthFractions);
+    }
+  }
+
+  //* Calorimetric summary [one entry per event, arrays of nLayers]
+  if (fSummaryMode) {
+    fSummaryNLayers = fPixelGeometry.GetNLayers();
+    fLayerEdeps.assign(fSummaryNLayers, 0.f);
+    fLayerNHits.assign(fSummaryNLayers, 0);
+    fLayerMeanRadii.assign(fSummaryNLayers, 0.f);
+    fSummaryTree = new TTree("summary", "summary_Tree");
+    fSummaryTree->Branch("event_id", &fPixelEventID, "event_id/l");
+    fSummaryTree->Branch("nLayers", &fSummaryNLayers, "nLayers/I");
+    fSummaryTree->Branch("layer_edep", fLayerEdeps.data(), "layer_edep[nLayers]/F");
+    fSummaryTree->Branch("layer_nHits", fLayerNHits.data(), "layer_nHits[nLayers]/I");
+    fSummaryTree->Branch("layer_meanRadius", fLayerMeanRadii.data(), "layer_meanRadius[nLayers]/F");
+    fSummaryTree->Branch("edep", &fSummaryEdep, "edep/F");
+    fSummaryTree->Branch("nHits", &fSummaryNHits, "nHits/I");
+    fSummaryTree->Branch("showerMaxLayer", &fShowerMaxLayer, "showerMaxLayer/I");
+    fSummaryTree->Branch("meanRadius", &fMeanRadius, "meanRadius/F");
+    fSummaryTree->Branch("rmsRadius", &fRmsRadius, "rmsRadius/F");
+  }
+
+  //* Pixel clusters [one entry per event]
+  if (fSaveClusters) {
+    fClustersTree = new TTree("clusters", "clusters_Tree");
+    fClustersTree->Branch("event_id", &fPixelEventID, "event_id/l");
+    fClustersTree->Branch("cluster_layerID", &fClusterLayerIDs);
+    fClustersTree->Branch("cluster_size", &fClusterSizes);
+    fClustersTree->Branch("cluster_energy", &fClusterEnergies);
+    fClustersTree->Branch("cluster_row", &fClusterRows);
+    fClustersTree->Branch("cluster_col", &fClusterCols);
+    fClustersTree->Branch("cluster_rowMin", &fClusterRowMins);
+    fClustersTree->Branch("cluster_rowMax", &fClusterRowMaxs);
+    fClustersTree->Branch("cluster_colMin", &fClusterColMins);
+    fClustersTree->Branch("cluster_colMax", &fClusterColMaxs);
+  }
+
+  //* Straight tracks [one entry per event]
+  if (fFindTracks) {
+    fTracksTree = new TTree("tracks", "tracks_Tree");
+    fTracksTree->Branch("event_id", &fPixelEventID, "event_id/l");
+    fTracksTree->Branch("track_x0", &fTrackX0s);
+    fTracksTree->Branch("track_y0", &fTrackY0s);
+    fTracksTree->Branch("track_tx", &fTrackTxs);
+    fTracksTree->Branch("track_ty", &fTrackTys);
+    fTracksTree->Branch("track_chi2", &fTrackChi2s);
+    fTracksTree->Branch("track_ndf", &fTrackNdfs);
+    fTracksTree->Branch("track_nHits", &fTrackNHits);
+    fTracksTree->Branch("track_firstLayer", &fTrackFirstLayers);
+    fTracksTree->Branch("track_lastLayer", &fTrackLastLayers);
+    fTracksTree->Branch("track_hitOffset", &fTrackHitOffsets);
+    fTracksTree->Branch("track_hitIndex", &fTrackHitIndices);
+    fTracksTree->Branch("track_trackID", &fTrackTrackIDs);
+    fTracksTree->Branch("track_purity", &fTrackPurities);
+  }
+
+  //* Digitised pixels, see PixelDigitizer
+  if (fSaveDigits) {
+    fPixelDigitsTree = new TTree("pixelDigits", "pixelDigits_Tree");
+    fPixelDigitsTree->Branch("event_id", &fPixelEventID, "event_id/l");
+    fPixelDigitsTree->Branch("digit_rowID", &fDigitRowIDs);
+    fPixelDigitsTree->Branch("digit_colID", &fDigitColIDs);
+    fPixelDigitsTree->Branch("digit_layerID", &fDigitLayerIDs);
+    fPixelDigitsTree->Branch("digit_charge", &fDigitCharges);
+  }
+
+  fFile->cd();
+}
+
+void AnalysisManager::bookActsTrees()
+{
+  // ACTS-compatible truth output, readable by ActsExamples::RootParticleReader
+  // and RootSimHitReader. Units follow ACTS: mm, ns, GeV.
+  fFile->cd(fHits->GetName());
+
+  //* Acts truth particle tree [one entry per event]
+  fActsParticlesTree = new TTree("particles", "ActsParticlesTree");
+  fActsParticlesTree->Branch("event_id", &ActsHitsEventId, "event_id/i");
+  fActsParticlesTree->Branch("particle_id", &ActsParticlesParticleId);
+  fActsParticlesTree->Branch("particle_type", &ActsParticlesParticleType);
+  fActsParticlesTree->Branch("process", &ActsParticlesProcess);
+  fActsParticlesTree->Branch("vx", &ActsParticlesVx);
+  fActsParticlesTree->Branch("vy", &ActsParticlesVy);
+  fActsParticlesTree->Branch("vz", &ActsParticlesVz);
+  fActsParticlesTree->Branch("vt", &ActsParticlesVt);
+  fActsParticlesTree->Branch("px", &ActsParticlesPx);
+  fActsParticlesTree->Branch("py", &ActsParticlesPy);
+  fActsParticlesTree->Branch("pz", &ActsParticlesPz);
+  fActsParticlesTree->Branch("m", &ActsParticlesM);
+  fActsParticlesTree->Branch("q", &ActsParticlesQ);
+  fActsParticlesTree->Branch("eta", &ActsParticlesEta);
+  fActsParticlesTree->Branch("phi", &ActsParticlesPhi);
+  fActsParticlesTree->Branch("pt", &ActsParticlesPt);
+  fActsParticlesTree->Branch("p", &ActsParticlesP);
+  fActsParticlesTree->Branch("vertex_primary", &ActsParticlesVertexPrimary);
+  fActsParticlesTree->Branch("vertex_secondary", &ActsParticlesVertexSecondary);
+  fActsParticlesTree->Branch("particle", &ActsParticlesParticle);
+  fActsParticlesTree->Branch("generation", &ActsParticlesGeneration);
+  fActsParticlesTree->Branch("sub_particle", &ActsParticlesSubParticle);
+  fActsParticlesTree->Branch("e_loss", &ActsParticlesELoss);
+  fActsParticlesTree->Branch("total_x0", &ActsParticlesPathInX0);
+  fActsParticlesTree->Branch("total_l0", &ActsParticlesPathInL0);
+  fActsParticlesTree->Branch("number_of_hits", &ActsParticlesNumberOfHits);
+  fActsParticlesTree->Branch("outcome", &ActsParticlesOutcome);
+
+  //* Acts simhit tree [one entry per hit]
+  fActsHitsTree = new TTree("hits", "ActsSimHitsTree");
+  fActsHitsTree->Branch("event_id", &ActsHitsEventId, "event_id/i");
+  fActsHitsTree->Branch("geometry_id", &ActsHitsGeometryId, "geometry_id/l");
+  fActsHitsTree->Branch("particle_id", &ActsHitsParticleId, "particle_id/l");
+  fActsHitsTree->Branch("tx", &ActsHitsTx, "tx/F");
+  fActsHitsTree->Branch("ty", &ActsHitsTy, "ty/F");
+  fActsHitsTree->Branch("tz", &ActsHitsTz, "tz/F");
+  fActsHitsTree->Branch("tt", &ActsHitsTt, "tt/F");
+  fActsHitsTree->Branch("tpx", &ActsHitsTpx, "tpx/F");
+  fActsHitsTree->Branch("tpy", &ActsHitsTpy, "tpy/F");
+  fActsHitsTree->Branch("tpz", &ActsHitsTpz, "tpz/F");
+  fActsHitsTree->Branch("te", &ActsHitsTe, "te/F");
+  fActsHitsTree->Branch("deltapx", &ActsHitsDeltaPx, "deltapx/F");
+  fActsHitsTree->Branch("deltapy", &ActsHitsDeltaPy, "deltapy/F");
+  fActsHitsTree->Branch("deltapz", &ActsHitsDeltaPz, "deltapz/F");
+  fActsHitsTree->Branch("deltae", &ActsHitsDeltaE, "deltae/F");
+  fActsHitsTree->Branch("index", &ActsHitsIndex, "index/I");
+  fActsHitsTree->Branch("volume_id", &ActsHitsVolumeId, "volume_id/i");
+  fActsHitsTree->Branch("boundary_id", &ActsHitsBoundaryId, "boundary_id/i");
+  fActsHitsTree->Branch("layer_id", &ActsHitsLayerId, "layer_id/i");
+  fActsHitsTree->Branch("approach_id", &ActsHitsApproachId, "approach_id/i");
+  fActsHitsTree->Branch("sensitive_id", &ActsHitsSensitiveId, "sensitive_id/i");
 
   fFile->cd();
 }
@@ -216,13 +429,25 @@ void AnalysisManager::BeginOfRun()
 
   // Preparing output file
   fFile = new TFile(fFilename.c_str(), "RECREATE");
+
+  fNEventsWritten = 0;
+  fRunStartWallTime = StartupTimer::Elapsed();
+  fRunStartCpuTime = ProcessCpuTime();
   
+  auto digitizer = static_cast<PixelDigitizer*>(G4DigiManager::GetDMpointer()->FindDigitizerModule("PixelDigitizer"));
+  fSaveDigits = digitizer && digitizer->IsEnabled();
+
+  auto detector = static_cast<const DetectorConstruction*>(G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  fPixelGeometry = detector->GetPixelGeometry();
+
   // Booking common output trees
   bookEvtTree();
   bookPrimTree();
   if (fSaveTrack) bookTrkTree();
 
   bookHitsTrees();
+  if (fSaveActs) bookActsTrees();
+  if (fSaveOccupancy) bookOccupancy();
 }
 
 //---------------------------------------------------------------------
@@ -233,13 +458,22 @@ void AnalysisManager::EndOfRun()
   G4cout << "Run has ended, closing output" << G4endl;
   // save common trees at the top of the output file
   fFile->cd();
+  WriteRunTree();
   fEvt->Write();
   fPrim->Write();
   if (fSaveTrack) fTrk->Write();
 
   fFile->cd(fHits->GetName());
-  fPixelHitsTree->Write();
-  // fActsParticlesTree->Write();
+  if (!fDropRawHits) fPixelHitsTree->Write();
+  if (fSaveClusters) fClustersTree->Write();
+  if (fSummaryMode) fSummaryTree->Write();
+  if (fFindTracks) fTracksTree->Write();
+  if (fSaveDigits) fPixelDigitsTree->Write();
+  if (fSaveActs) {
+    fActsParticlesTree->Write();
+    fActsHitsTree->Write();
+  }
+  if (fSaveOccupancy) WriteOccupancy();
   fFile->cd(); // go back to top
 
   fFile->Close();
@@ -248,6 +482,120 @@ void AnalysisManager::EndOfRun()
 //---------------------------------------------------------------------
 //---------------------------------------------------------------------
 
+void AnalysisManager::WriteRunTree()
+{
+  auto detector = static_cast<const DetectorConstruction*>(G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+
+  // geometry [mm]
+  Int_t nLayers = detector->GetNlayers();
+  Double_t tungstenThickness = detector->GetTungstenThickness() / mm;
+  Double_t siliconThickness = detector->GetSiliconThickness() / mm;
+  Double_t pixelWidth = detector->GetPixelWidth() / mm;
+  Double_t pixelHeight = detector->GetPixelHeight() / mm;
+  Double_t detectorWidth = detector->GetDetectorWidth() / mm;
+  Double_t detectorHeight = detector->GetDetectorHeight() / mm;
+  Double_t layerThickness = detector->GetLayerThickness() / mm;
+  Double_t siliconZ = detector->GetPixelGeometry().Z(0) / mm;
+  std::string geometryHash = detector->GeometryHash();
+
+  TTree* run = new TTree("run", "run info");
+  run->Branch("det_nLayers", &nLayers, "det_nLayers/I");
+  run->Branch("det_tungstenThickness", &tungstenThickness, "det_tungstenThickness/D");
+  run->Branch("det_siliconThickness", &siliconThickness, "det_siliconThickness/D");
+  run->Branch("det_pixelWidth", &pixelWidth, "det_pixelWidth/D");
+  run->Branch("det_pixelHeight", &pixelHeight, "det_pixelHeight/D");
+  run->Branch("det_detectorWidth", &detectorWidth, "det_detectorWidth/D");
+  run->Branch("det_detectorHeight", &detectorHeight, "det_detectorHeight/D");
+  run->Branch("det_layerThickness", &layerThickness, "det_layerThickness/D");
+  run->Branch("det_siliconZ", &siliconZ, "det_siliconZ/D");
+  run->Branch("det_geometryHash", &geometryHash);
+
+  // settings: effective value of every recorded command, defaults included;
+  // commands whose messenger does not report one (e.g. some /gps/ commands)
+  // get the last value applied, if any
+  std::map<std::string, std::string> settings, applied;
+  G4UImanager* ui = G4UImanager::GetUIpointer();
+  CollectSettings(ui->GetTree(), settings);
+  for (G4int i = 0; i < ui->GetNumberOfHistory(); i++) {
+    std::string command = ui->GetPreviousCommand(i);
+    std::size_t space = command.find(' ');
+    std::string path = command.substr(0, space);
+    if (IsRecorded(path)) applied[path] = (space == std::string::npos) ? "" : command.substr(space + 1);
+  }
+  for (const auto& [path, value] : applied) {
+    if (settings[path].empty()) settings[path] = value;
+  }
+  std::vector<std::string> settingName, settingValue;
+  for (const auto& [name, value] : settings) {
+    settingName.push_back(name);
+    settingValue.push_back(value);
+  }
+  std::string outputFile = fFilename;
+  Long64_t masterSeed = SeedService::GetInstance()->GetMasterSeed();
+  run->Branch("settingName", &settingName);
+  run->Branch("settingValue", &settingValue);
+  run->Branch("outputFile", &outputFile);
+  run->Branch("masterSeed", &masterSeed, "masterSeed/L");
+
+  // software
+  std::string physicsList = fPhysicsListName;
+  std::string pinpointVersion = PINPOINT_VERSION;
+  std::string geant4Version = G4Version;
+  std::string rootVersion = gROOT->GetVersion();
+  run->Branch("physicsList", &physicsList);
+  run->Branch("pinpointVersion", &pinpointVersion);
+  run->Branch("geant4Version", &geant4Version);
+  run->Branch("rootVersion", &rootVersion);
+
+  // event counts and throughput
+  const G4Run* currentRun = G4RunManager::GetRunManager()->GetCurrentRun();
+  Int_t runID = currentRun ? currentRun->GetRunID() : -1;
+  Long64_t nEventsRequested = currentRun ? currentRun->GetNumberOfEventToBeProcessed() : 0;
+  Long64_t nEventsProcessed = currentRun ? currentRun->GetNumberOfEvent() : 0;
+  Long64_t nEventsWritten = fNEventsWritten;
+  Double_t runWallTime = StartupTimer::Elapsed() - fRunStartWallTime; // [s]
+  Double_t runCpuTime = ProcessCpuTime() - fRunStartCpuTime;          // [s]
+  Double_t totalWallTime = StartupTimer::Elapsed();                   // [s], including initialisation
+  Double_t totalCpuTime = ProcessCpuTime();                           // [s]
+  Double_t eventsPerSecond = runWallTime > 0 ? nEventsProcessed / runWallTime : 0.;
+  Double_t peakRSS = PeakRSS();                                       // [MB]
+  run->Branch("runID", &runID, "runID/I");
+  run->Branch("nEventsRequested", &nEventsRequested, "nEventsRequested/L");
+  run->Branch("nEventsProcessed", &nEventsProcessed, "nEventsProcessed/L");
+  run->Branch("nEventsWritten", &nEventsWritten, "nEventsWritten/L");
+  run->Branch("runWallTime", &runWallTime, "runWallTime/D");
+  run->Branch("runCpuTime", &runCpuTime, "runCpuTime/D");
+  run->Branch("totalWallTime", &totalWallTime, "totalWallTime/D");
+  run->Branch("totalCpuTime", &totalCpuTime, "totalCpuTime/D");
+  run->Branch("eventsPerSecond", &eventsPerSecond, "eventsPerSecond/D");
+  run->Branch("peakRSS", &peakRSS, "peakRSS/D");
+
+  // host
+  char hostBuffer[256] = "";
+  gethostname(hostBuffer, sizeof(hostBuffer) - 1);
+  std::string host = hostBuffer;
+  utsname system;
+  std::string os = (uname(&system) == 0) ? std::string(system.sysname) + " " + system.release + " " + system.machine : "unknown";
+  Int_t nCores = std::thread::hardware_concurrency();
+  char timeBuffer[32] = "";
+  std::time_t now = std::time(nullptr);
+  std::strftime(timeBuffer, sizeof(timeBuffer), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+  std::string endTime = timeBuffer;
+  run->Branch("host", &host);
+  run->Branch("os", &os);
+  run->Branch("nCores", &nCores, "nCores/I");
+  run->Branch("endTime", &endTime);
+
+  run->Fill();
+  run->Write();
+
+  G4cout << "Run summary: " << nEventsProcessed << " events in " << runWallTime << " s wall, " << runCpuTime << " s CPU ("
+         << eventsPerSecond << " events/s), peak RSS " << peakRSS << " MB" << G4endl;
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
 void AnalysisManager::BeginOfEvent()
 {
   G4cout << "Starting new event, resetting variables" << G4endl;
@@ -260,6 +608,13 @@ void AnalysisManager::BeginOfEvent()
   // track ID to primary ancestor association
   trackToPrimaryAncestor.clear();
 
+  fHitIndexBuilt = false;
+  fHCofEvent = nullptr;
+
+  // ACTS truth records, keep the capacity from previous events
+  fActsParticleRecords.clear();
+  fActsPrimaryBarcodes.clear();
+
   trackPointX.clear();
   trackPointY.clear();
   trackPointZ.clear();
@@ -274,6 +629,43 @@ void AnalysisManager::BeginOfEvent()
   fPixelPzs.clear();
   fPixelEnergies.clear();
   fPixelCharges.clear();
+  fPixelClusterIDs.clear();
+  fPixelEdeps.clear();
+  fPixelXs.clear();
+  fPixelYs.clear();
+  fPixelZs.clear();
+  fPixelTruthOffsets.clear();
+  fTruthTrackIDs.clear();
+  fTruthFractions.clear();
+
+  fClusterLayerIDs.clear();
+  fClusterSizes.clear();
+  fClusterEnergies.clear();
+  fClusterRows.clear();
+  fClusterCols.clear();
+  fClusterRowMins.clear();
+  fClusterRowMaxs.clear();
+  fClusterColMins.clear();
+  fClusterColMaxs.clear();
+
+  fTrackX0s.clear();
+  fTrackY0s.clear();
+  fTrackTxs.clear();
+  fTrackTys.clear();
+  fTrackChi2s.clear();
+  fTrackNdfs.clear();
+  fTrackNHits.clear();
+  fTrackFirstLayers.clear();
+  fTrackLastLayers.clear();
+  fTrackHitOffsets.clear();
+  fTrackHitIndices.clear();
+  fTrackTrackIDs.clear();
+  fTrackPurities.clear();
+
+  fDigitRowIDs.clear();
+  fDigitColIDs.clear();
+  fDigitLayerIDs.clear();
+  fDigitCharges.clear();
 
   ActsParticlesParticleId.clear();
   ActsParticlesParticleType.clear();
@@ -309,11 +701,14 @@ void AnalysisManager::BeginOfEvent()
 void AnalysisManager::EndOfEvent(const G4Event *event)
 {
   G4cout << "Ending event, filling output trees" << G4endl;
-  /// evtID
-  evtID = event->GetEventID();
+  /// evtID: index of the event in the whole sample, so that it stays unique
+  /// when the outputs of several jobs or shards are merged
+  auto eventInfo = static_cast<const EventInformation*>(event->GetUserInformation());
+  evtID = (eventInfo && eventInfo->GetEventIndex() >= 0) ? eventInfo->GetEventIndex() : event->GetEventID();
 
   // FILL EVENT TREE
   FillEventTree(event);
+  fNEventsWritten++;
 
   //-----------------------------------------------------------
 
@@ -321,6 +716,9 @@ void AnalysisManager::EndOfEvent(const G4Event *event)
   FillPrimariesTree(event);
   if(fSaveTrack) FillTrajectoriesTree(event);
 
+  // FILL DIGITS TREE, one entry per event even without any hits
+  if (fSaveDigits) FillDigitsOutput(event);
+
   //-----------------------------------------------------------
 
   // Get the hit collections
@@ -329,10 +727,17 @@ void AnalysisManager::EndOfEvent(const G4Event *event)
   if (!fHCofEvent)
   {
     G4cout << "No hits recorded in any sensitive volume --> nothing to save!" << G4endl;
+    if (fSummaryMode) FillSummaryTree(event);
+    if (fFindTracks) FillTracks();
+    if (fSaveOccupancy) FillOccupancy();
     return;
   }
 
   FillHitsOutput();
+  if (fSummaryMode) FillSummaryTree(event);
+  if (fFindTracks) FillTracks();
+  if (fSaveOccupancy) FillOccupancy();
+  if (fSaveActs) FillActsOutput();
 
 }
 
@@ -523,6 +928,7 @@ void AnalysisManager::FillHitsOutput()
           fPixelPzs.push_back(hit->GetPz());
           fPixelEnergies.push_back(hit->GetEnergy());
           fPixelCharges.push_back(hit->GetCharge());
+          fPixelEdeps.push_back(hit->GetEnergyDeposit());
 
           // G4cout << "Filling hit: TrackID=" << hit->GetTrackID() 
           //        << " PDG=" << hit->GetPDGCode() 
@@ -533,14 +939,427 @@ void AnalysisManager::FillHitsOutput()
           //        << G4endl;
 
       }
-  
-      fPixelHitsTree->Fill();
+
+      if (fSaveHitPositions) {
+        std::size_t n = fPixelLayerIDs.size();
+        fPixelXs.resize(n);
+        fPixelYs.resize(n);
+        fPixelZs.resize(n);
+        fPixelGeometry.ToGlobal(n, fPixelLayerIDs.data(), fPixelRowIDs.data(), fPixelColIDs.data(),
+                                fPixelXs.data(), fPixelYs.data(), fPixelZs.data());
+      }
+      if (fSaveTruthLinks) {
+        auto pixelSD = dynamic_cast<PixelSD*>(G4SDManager::GetSDMpointer()->FindSensitiveDetector("PixelDetector", false));
+        if (pixelSD) {
+          const PixelTruthLinks& links = pixelSD->GetTruthLinks();
+          fPixelTruthOffsets.assign(links.offset.begin(), links.offset.end());
+          fTruthTrackIDs.assign(links.trackID.begin(), links.trackID.end());
+          fTruthFractions.assign(links.fraction.begin(), links.fraction.end());
+        }
+      }
+      if (fSaveClusters) FillClusters();
+      if (!fDropRawHits) fPixelHitsTree->Fill();
       
     } 
   } // Close loop over hit collections
 }
 
+const HitIndex& AnalysisManager::GetHitIndex()
+{
+  if (fHitIndexBuilt) return fHitIndex;
+  fHitIndexBuilt = true;
+
+  fHitIndex.Clear();
+  for (G4int i = 0; fHCofEvent && i < fHCofEvent->GetNumberOfCollections(); ++i) {
+    auto* pixelHitCollection = dynamic_cast<PixelHitsCollection*>(fHCofEvent->GetHC(i));
+    if (pixelHitCollection && pixelHitCollection->GetName() == "PixelHitsCollection") {
+      fHitIndex.Build(*pixelHitCollection);
+      return fHitIndex;
+    }
+  }
+  fHitIndex.Build();
+  return fHitIndex;
+}
+
+void AnalysisManager::bookOccupancy()
+{
+  fOccupancyDir = fFile->mkdir("Occupancy", "Occupancy histograms", kTRUE);
+  fOccupancyDir->cd();
+
+  const G4int nLayers = fPixelGeometry.GetNLayers();
+  const G4int rebin = std::max(1, fOccupancyRebin);
+  const G4int nRowBins = (fPixelGeometry.GetNRows() + rebin - 1) / rebin;
+  const G4int nColBins = (fPixelGeometry.GetNCols() + rebin - 1) / rebin;
+  Int_t bins[3] = {nLayers, nRowBins, nColBins};
+  Double_t xmin[3] = {0., 0., 0.};
+  Double_t xmax[3] = {Double_t(nLayers), Double_t(nRowBins * rebin), Double_t(nColBins * rebin)};
+  fHitMap = new THnSparseF("hitMap", "hits;layer;row;col", 3, bins, xmin, xmax);
+
+  fModuleHits = new TH2F("moduleHits", "hits per module with hits, per event;layer;hits", nLayers, 0, nLayers, 500, 0, 5000);
+  fMaxModuleHits = new TH1F("maxModuleHits", "hits in the busiest module, per event;hits;events", 500, 0, 5000);
+  fHitEdep = new TH1F("hitEdep", "deposit per hit;E_{dep} [keV];hits", 500, 0, 500);
+  fLayerEdep = new TH2F("layerEdep", "deposit per layer, per event;layer;E_{dep} [MeV]", nLayers, 0, nLayers, 500, 0, 100);
+  fEventEdep = new TH1F("eventEdep", "deposit per event;E_{dep} [MeV];events", 1000, 0, 1000);
+
+  // module counts from the hit index of the event
+  fHitIndex.SetModuleSize(std::max(1, static_cast<G4int>(fModuleWidth / fPixelGeometry.GetPitchX())),
+                          std::max(1, static_cast<G4int>(fModuleHeight / fPixelGeometry.GetPitchY())));
+  fFile->cd();
+}
+
+void AnalysisManager::FillOccupancy()
+{
+  G4double eventEdep = 0.;
+  std::vector<G4double> layerEdep(fPixelGeometry.GetNLayers(), 0.);
+  for (std::size_t i = 0; i < fPixelLayerIDs.size(); ++i) {
+    Double_t x[3] = {fPixelLayerIDs[i], fPixelRowIDs[i], fPixelColIDs[i]};
+    fHitMap->Fill(x);
+    fHitEdep->Fill(fPixelEdeps[i] / keV);
+    eventEdep += fPixelEdeps[i];
+    G4int layer = static_cast<G4int>(fPixelLayerIDs[i]);
+    if (layer >= 0 && layer < (G4int)layerEdep.size()) layerEdep[layer] += fPixelEdeps[i];
+  }
+  fEventEdep->Fill(eventEdep / MeV);
+  for (std::size_t layer = 0; layer < layerEdep.size(); ++layer) {
+    if (layerEdep[layer] > 0.) fLayerEdep->Fill(static_cast<Double_t>(layer), layerEdep[layer] / MeV);
+  }
+
+  G4int maxHits = 0;
+  GetHitIndex().ForEachModule([&](G4int layer, G4int, G4int, G4int count) {
+    fModuleHits->Fill(layer, count);
+    maxHits = std::max(maxHits, count);
+  });
+  fMaxModuleHits->Fill(maxHits);
+}
+
+void AnalysisManager::WriteOccupancy()
+{
+  // the application runs one event loop per job, so these are the totals of
+  // the job; pinpoint_merge adds them up across jobs
+  fOccupancyDir->cd();
+  fHitMap->Write();
+  fModuleHits->Write();
+  fMaxModuleHits->Write();
+  fHitEdep->Write();
+  fLayerEdep->Write();
+  fEventEdep->Write();
+  // THnSparse is not owned by the directory
+  delete fHitMap;
+  fHitMap = nullptr;
+}
+
+void AnalysisManager::FillSummaryTree(const G4Event* event)
+{
+  fPixelEventID = evtID;
+  std::fill(fLayerEdeps.begin(), fLayerEdeps.end(), 0.f);
+  std::fill(fLayerNHits.begin(), fLayerNHits.end(), 0);
+  std::fill(fLayerMeanRadii.begin(), fLayerMeanRadii.end(), 0.f);
+
+  // primary axis: from the first vertex along the summed momentum of its
+  // visible primaries (the beam axis if there are none)
+  G4ThreeVector origin, axis;
+  if (event->GetNumberOfPrimaryVertex() > 0) {
+    const G4PrimaryVertex* vertex = event->GetPrimaryVertex(0);
+    origin = vertex->GetPosition();
+    for (G4int i = 0; i < vertex->GetNumberOfParticle(); ++i) {
+      const G4PrimaryParticle* particle = vertex->GetPrimary(i);
+      G4int pdg = std::abs(particle->GetPDGcode());
+      if (pdg == 12 || pdg == 14 || pdg == 16) continue;
+      axis += particle->GetMomentum();
+    }
+  }
+  axis = axis.mag2() > 0. ? axis.unit() : G4ThreeVector(0., 0., 1.);
+
+  // pixel centres
+  const std::size_t nHits = fPixelLayerIDs.size();
+  fPixelXs.resize(nHits);
+  fPixelYs.resize(nHits);
+  fPixelZs.resize(nHits);
+  fPixelGeometry.ToGlobal(nHits, fPixelLayerIDs.data(), fPixelRowIDs.data(), fPixelColIDs.data(),
+                          fPixelXs.data(), fPixelYs.data(), fPixelZs.data());
+
+  G4double sumE = 0., sumER = 0., sumER2 = 0.;
+  for (std::size_t i = 0; i < nHits; ++i) {
+    G4int layer = static_cast<G4int>(fPixelLayerIDs[i]);
+    if (layer < 0 || layer >= fSummaryNLayers) continue;
+    G4double edep = fPixelEdeps[i];
+    G4double r = (G4ThreeVector(fPixelXs[i], fPixelYs[i], fPixelZs[i]) - origin).perp(axis);
+    fLayerEdeps[layer] += edep;
+    fLayerNHits[layer]++;
+    fLayerMeanRadii[layer] += edep * r;
+    sumE += edep;
+    sumER += edep * r;
+    sumER2 += edep * r * r;
+  }
+
+  fShowerMaxLayer = -1;
+  for (G4int layer = 0; layer < fSummaryNLayers; ++layer) {
+    if (fLayerEdeps[layer] > 0.) fLayerMeanRadii[layer] /= fLayerEdeps[layer];
+    if (fLayerEdeps[layer] > 0. && (fShowerMaxLayer < 0 || fLayerEdeps[layer] > fLayerEdeps[fShowerMaxLayer]))
+      fShowerMaxLayer = layer;
+  }
+  fSummaryEdep = sumE;
+  fSummaryNHits = static_cast<Int_t>(nHits);
+  fMeanRadius = sumE > 0. ? sumER / sumE : 0.;
+  fRmsRadius = sumE > 0. ? std::sqrt(std::max(0., sumER2 / sumE - fMeanRadius * fMeanRadius)) : 0.;
+
+  fSummaryTree->Fill();
+}
+
+void AnalysisManager::FillClusters()
+{
+  fClustering.Clear();
+  for (std::size_t i = 0; i < fPixelLayerIDs.size(); ++i)
+    fClustering.AddHit(fPixelLayerIDs[i], fPixelRowIDs[i], fPixelColIDs[i], fPixelEdeps[i]);
+
+  for (const auto& cluster : fClustering.Run()) {
+    fClusterLayerIDs.push_back(cluster.layer);
+    fClusterSizes.push_back(cluster.size);
+    fClusterEnergies.push_back(cluster.weight);
+    fClusterRows.push_back(cluster.row);
+    fClusterCols.push_back(cluster.col);
+    fClusterRowMins.push_back(cluster.rowMin);
+    fClusterRowMaxs.push_back(cluster.rowMax);
+    fClusterColMins.push_back(cluster.colMin);
+    fClusterColMaxs.push_back(cluster.colMax);
+  }
+  const auto& hitClusters = fClustering.GetHitClusters();
+  fPixelClusterIDs.assign(hitClusters.begin(), hitClusters.end());
+  fClustersTree->Fill();
+}
+
+void AnalysisManager::FillTracks()
+{
+  fPixelEventID = evtID;
+  // HitIndex entries are in hit collection order, like the pixelHits vectors
+  const auto& tracks = fTrackFinder.Find(GetHitIndex(), fPixelGeometry);
+  std::vector<G4int> trackIDs;
+  for (const auto& track : tracks) {
+    fTrackX0s.push_back(track.x0);
+    fTrackY0s.push_back(track.y0);
+    fTrackTxs.push_back(track.tx);
+    fTrackTys.push_back(track.ty);
+    fTrackChi2s.push_back(track.chi2);
+    fTrackNdfs.push_back(track.ndf);
+    fTrackNHits.push_back(track.hits.size());
+    fTrackFirstLayers.push_back(track.firstLayer);
+    fTrackLastLayers.push_back(track.lastLayer);
+    fTrackHitOffsets.push_back(fTrackHitIndices.size());
+    fTrackHitIndices.insert(fTrackHitIndices.end(), track.hits.begin(), track.hits.end());
+
+    // truth match: most frequent track ID of the hits
+    trackIDs.clear();
+    for (int hit : track.hits) trackIDs.push_back(fPixelTrackIDs[hit]);
+    std::sort(trackIDs.begin(), trackIDs.end());
+    G4int bestID = -1;
+    std::size_t bestCount = 0;
+    for (std::size_t i = 0, j = 0; i < trackIDs.size(); i = j) {
+      while (j < trackIDs.size() && trackIDs[j] == trackIDs[i]) ++j;
+      if (j - i > bestCount) {
+        bestID = trackIDs[i];
+        bestCount = j - i;
+      }
+    }
+    fTrackTrackIDs.push_back(bestID);
+    fTrackPurities.push_back(static_cast<Float_t>(bestCount) / track.hits.size());
+  }
+  if (!tracks.empty())
+    G4cout << "Found " << tracks.size() << " straight track(s)" << G4endl;
+  fTracksTree->Fill();
+}
+
+void AnalysisManager::FillDigitsOutput(const G4Event* event)
+{
+  fPixelEventID = evtID;
+  G4DCofThisEvent* dce = event->GetDCofThisEvent();
+  G4int dcID = G4DigiManager::GetDMpointer()->GetDigiCollectionID("PixelDigitizer/PixelDigits");
+  auto digits = (dce && dcID >= 0) ? static_cast<PixelDigiCollection*>(dce->GetDC(dcID)) : nullptr;
+  if (digits) {
+    for (auto digi : *digits->GetVector()) {
+      fDigitRowIDs.push_back(digi->GetRowID());
+      fDigitColIDs.push_back(digi->GetColID());
+      fDigitLayerIDs.push_back(digi->GetLayerID());
+      fDigitCharges.push_back(digi->GetCharge());
+    }
+  }
+  fPixelDigitsTree->Fill();
+}
+
 float_t AnalysisManager::GetTotalEnergy(float_t px, float_t py, float_t pz, float_t m)
 {
   return TMath::Sqrt(px * px + py * py + pz * pz + m * m);
 }
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+void AnalysisManager::RegisterActsParticle(const G4Track* track)
+{
+  G4int trackID = track->GetTrackID();
+  G4int parentID = track->GetParentID();
+  if (trackID >= (G4int)fActsParticleRecords.size())
+    fActsParticleRecords.resize(trackID + 1);
+
+  ActsParticleRecord& record = fActsParticleRecords[trackID];
+  if (parentID == 0)
+  {
+    // same (vertex, particle) numbering as the primaries tree
+    if (fActsPrimaryBarcodes.empty())
+    {
+      const G4Event* event = G4EventManager::GetEventManager()->GetConstCurrentEvent();
+      for (G4int ivtx = 0; ivtx < event->GetNumberOfPrimaryVertex(); ++ivtx)
+        for (G4int ipp = 0; ipp < event->GetPrimaryVertex(ivtx)->GetNumberOfParticle(); ++ipp)
+          fActsPrimaryBarcodes[event->GetPrimaryVertex(ivtx)->GetPrimary(ipp)] =
+            ActsFatras::Barcode().setVertexPrimary(ivtx).setParticle(ipp);
+    }
+    auto it = fActsPrimaryBarcodes.find(track->GetDynamicParticle()->GetPrimaryParticle());
+    record.primaryBarcode = (it != fActsPrimaryBarcodes.end()) 
+                          ? it->second 
+                          : ActsFatras::Barcode().setParticle(trackID - 1);
+    record.generation = 0;
+    record.process = 0;
+  }
+  else
+  {
+    // parents are always stacked (and registered) before their secondaries
+    const ActsParticleRecord& parent = fActsParticleRecords.at(parentID);
+    record.primaryBarcode = parent.primaryBarcode;
+    record.generation = parent.generation + 1;
+    record.process = track->GetCreatorProcess() ? track->GetCreatorProcess()->GetProcessSubType() : 0;
+  }
+
+  record.registered = true;
+  record.pdg = track->GetParticleDefinition()->GetPDGEncoding();
+  record.mass = track->GetParticleDefinition()->GetPDGMass();
+  record.charge = track->GetParticleDefinition()->GetPDGCharge();
+  record.x4 = G4LorentzVector(track->GetPosition(), track->GetGlobalTime());
+  record.p4 = G4LorentzVector(track->GetMomentum(), track->GetTotalEnergy());
+}
+
+void AnalysisManager::FinalizeActsParticle(const G4Track* track)
+{
+  G4int trackID = track->GetTrackID();
+  if (trackID >= (G4int)fActsParticleRecords.size()) return;
+
+  ActsParticleRecord& record = fActsParticleRecords[trackID];
+  record.eLoss = (record.p4.e() - record.mass) - track->GetKineticEnergy();
+  // ActsFatras::SimulationOutcome: KilledInteraction = 1, KilledVolumeExit = 2
+  record.outcome = (track->GetNextVolume() == nullptr) ? 2 : 1;
+}
+
+void AnalysisManager::AddActsMaterial(G4int trackID, G4double pathInX0, G4double pathInL0)
+{
+  if (trackID >= (G4int)fActsParticleRecords.size()) return;
+  fActsParticleRecords[trackID].pathInX0 += pathInX0;
+  fActsParticleRecords[trackID].pathInL0 += pathInL0;
+}
+
+//---------------------------------------------------------------------
+//---------------------------------------------------------------------
+
+void AnalysisManager::FillActsOutput()
+{
+  G4cout << "==== Filling ACTS output trees ====" << G4endl;
+  ActsHitsEventId = evtID; // ACTS reads a 32-bit event_id
+
+  ActsHitsCollection* actsHitCollection = nullptr;
+  for (G4int i = 0; i < fHCofEvent->GetNumberOfCollections(); ++i) {
+    auto* hc = dynamic_cast<ActsHitsCollection*>(fHCofEvent->GetHC(i));
+    if (hc && hc->GetName() == "ActsHitsCollection") actsHitCollection = hc;
+  }
+
+  // count hits per track: only primaries and particles leaving hits are written
+  if (actsHitCollection) {
+    for (auto hit : *actsHitCollection->GetVector()) {
+      G4int trackID = hit->GetTrackID();
+      if (trackID < (G4int)fActsParticleRecords.size())
+        fActsParticleRecords[trackID].nHits++;
+    }
+  }
+
+  // assign barcodes in track ID order, numbering sub-particles within each
+  // (vertex, particle, generation) so that they are unique in the event
+  std::vector<ActsFatras::Barcode> barcodes(fActsParticleRecords.size());
+  std::map<ActsFatras::Barcode::Value, ActsFatras::Barcode::Value> subParticleCounter;
+  const G4int maxGeneration = (1 << ActsFatras::Barcode::bits(3)) - 1;
+
+  for (size_t trackID = 0; trackID < fActsParticleRecords.size(); ++trackID)
+  {
+    const ActsParticleRecord& record = fActsParticleRecords[trackID];
+    if (!record.registered) continue;
+    if (record.generation > 0 && record.nHits == 0) continue;
+
+    ActsFatras::Barcode barcode = record.primaryBarcode;
+    if (record.generation > 0) {
+      barcode.setGeneration(std::min(record.generation, maxGeneration));
+      barcode.setSubParticle(subParticleCounter[barcode.value()]++);
+    }
+    barcodes[trackID] = barcode;
+
+    G4LorentzVector p4 = record.p4 / GeV;
+    ActsParticlesParticleId.push_back(barcode.value());
+    ActsParticlesParticleType.push_back(record.pdg);
+    ActsParticlesProcess.push_back(record.process);
+    ActsParticlesVx.push_back(record.x4.x() / mm);
+    ActsParticlesVy.push_back(record.x4.y() / mm);
+    ActsParticlesVz.push_back(record.x4.z() / mm);
+    ActsParticlesVt.push_back(record.x4.t() / ns);
+    ActsParticlesPx.push_back(p4.px());
+    ActsParticlesPy.push_back(p4.py());
+    ActsParticlesPz.push_back(p4.pz());
+    ActsParticlesM.push_back(record.mass / GeV);
+    ActsParticlesQ.push_back(record.charge);
+    ActsParticlesEta.push_back(p4.eta());
+    ActsParticlesPhi.push_back(p4.phi());
+    ActsParticlesPt.push_back(p4.perp());
+    ActsParticlesP.push_back(p4.vect().mag());
+    ActsParticlesVertexPrimary.push_back(barcode.vertexPrimary());
+    ActsParticlesVertexSecondary.push_back(barcode.vertexSecondary());
+    ActsParticlesParticle.push_back(barcode.particle());
+    ActsParticlesGeneration.push_back(barcode.generation());
+    ActsParticlesSubParticle.push_back(barcode.subParticle());
+    ActsParticlesELoss.push_back(record.eLoss / GeV);
+    ActsParticlesPathInX0.push_back(record.pathInX0);
+    ActsParticlesPathInL0.push_back(record.pathInL0);
+    ActsParticlesNumberOfHits.push_back(record.nHits);
+    ActsParticlesOutcome.push_back(record.outcome);
+  }
+  fActsParticlesTree->Fill();
+
+  if (!actsHitCollection) return;
+
+  // hit index along each particle trajectory
+  std::vector<G4int> hitIndex(fActsParticleRecords.size(), 0);
+  for (auto hit : *actsHitCollection->GetVector())
+  {
+    G4int trackID = hit->GetTrackID();
+    if (trackID >= (G4int)fActsParticleRecords.size()) continue;
+
+    GeometryId geoId = GeometryId::PixelPlane(hit->GetLayerID());
+    const G4LorentzVector& x4 = hit->GetX4();
+    G4LorentzVector p4 = hit->GetP4Before() / GeV;
+    G4LorentzVector dp4 = (hit->GetP4After() - hit->GetP4Before()) / GeV;
+
+    ActsHitsGeometryId = geoId.value();
+    ActsHitsParticleId = barcodes[trackID].value();
+    ActsHitsTx = x4.x() / mm;
+    ActsHitsTy = x4.y() / mm;
+    ActsHitsTz = x4.z() / mm;
+    ActsHitsTt = x4.t() / ns;
+    ActsHitsTpx = p4.px();
+    ActsHitsTpy = p4.py();
+    ActsHitsTpz = p4.pz();
+    ActsHitsTe = p4.e();
+    ActsHitsDeltaPx = dp4.px();
+    ActsHitsDeltaPy = dp4.py();
+    ActsHitsDeltaPz = dp4.pz();
+    ActsHitsDeltaE = dp4.e();
+    ActsHitsIndex = hitIndex[trackID]++;
+    ActsHitsVolumeId = geoId.volume();
+    ActsHitsBoundaryId = geoId.boundary();
+    ActsHitsLayerId = geoId.layer();
+    ActsHitsApproachId = geoId.approach();
+    ActsHitsSensitiveId = geoId.sensitive();
+    fActsHitsTree->Fill();
+  }
+}
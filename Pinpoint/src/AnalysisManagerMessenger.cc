@@ -27,7 +27,7 @@
 
 #include "AnalysisManagerMessenger.hh"
 
-//#include <sstream>
+#include <sstream>
 
 #include "AnalysisManager.hh"
 #include "G4UIdirectory.hh"
@@ -36,6 +36,7 @@
 #include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWithAnInteger.hh"
 #include "G4UIcmdWithABool.hh"
+#include "G4SystemOfUnits.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -53,6 +54,67 @@
   fSaveTrackCmd->SetGuidance("whether save the information of all tracks");
   fSaveTrackCmd->SetParameterName("saveTrack", true);
   fSaveTrackCmd->SetDefaultValue(false);
+
+  fSaveActsCmd = new G4UIcmdWithABool("/out/saveActs", this);
+  fSaveActsCmd->SetGuidance("write ACTS-format truth particles and simhits (Hits/particles, Hits/hits)");
+  fSaveActsCmd->SetParameterName("saveActs", true);
+  fSaveActsCmd->SetDefaultValue(false);
+
+  fSaveClustersCmd = new G4UIcmdWithABool("/out/saveClusters", this);
+  fSaveClustersCmd->SetGuidance("cluster the pixel hits of every layer and write them (Hits/clusters)");
+  fSaveClustersCmd->SetParameterName("saveClusters", true);
+  fSaveClustersCmd->SetDefaultValue(true);
+
+  fClusterConnectivityCmd = new G4UIcmdWithAnInteger("/out/clusterConnectivity", this);
+  fClusterConnectivityCmd->SetGuidance("pixels sharing an edge (4) or also a corner (8) belong to the same cluster");
+  fClusterConnectivityCmd->SetParameterName("connectivity", false);
+  fClusterConnectivityCmd->SetCandidates("4 8");
+
+  fDropRawHitsCmd = new G4UIcmdWithABool("/out/dropRawHits", this);
+  fDropRawHitsCmd->SetGuidance("do not write the pixelHits tree, e.g. when only the clusters are needed");
+  fDropRawHitsCmd->SetParameterName("dropRawHits", true);
+  fDropRawHitsCmd->SetDefaultValue(true);
+
+  fSaveTruthLinksCmd = new G4UIcmdWithABool("/out/saveTruthLinks", this);
+  fSaveTruthLinksCmd->SetGuidance("write every track contributing to a pixel hit and its share of the deposit (pixelHits tree)");
+  fSaveTruthLinksCmd->SetParameterName("saveTruthLinks", true);
+  fSaveTruthLinksCmd->SetDefaultValue(true);
+
+  fSaveHitPositionsCmd = new G4UIcmdWithABool("/out/saveHitPositions", this);
+  fSaveHitPositionsCmd->SetGuidance("write the global position of the pixel centre of every hit (hit_x, hit_y, hit_z in mm)");
+  fSaveHitPositionsCmd->SetParameterName("saveHitPositions", true);
+  fSaveHitPositionsCmd->SetDefaultValue(true);
+
+  fModeCmd = new G4UIcmdWithAString("/out/mode", this);
+  fModeCmd->SetGuidance("full: usual output; summary: also write per-layer energy and hit profiles and radial moments (summary tree)");
+  fModeCmd->SetGuidance("combine summary with /out/dropRawHits for a minimal output");
+  fModeCmd->SetParameterName("mode", false);
+  fModeCmd->SetCandidates("full summary");
+  fModeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fSaveOccupancyCmd = new G4UIcmdWithABool("/out/saveOccupancy", this);
+  fSaveOccupancyCmd->SetGuidance("accumulate occupancy histograms over the run: hit maps, hits per module and energy spectra (Occupancy/)");
+  fSaveOccupancyCmd->SetParameterName("saveOccupancy", true);
+  fSaveOccupancyCmd->SetDefaultValue(true);
+
+  fOccupancyRebinCmd = new G4UIcmdWithAnInteger("/out/occupancyRebin", this);
+  fOccupancyRebinCmd->SetGuidance("pixels per bin of the hit maps, along rows and columns");
+  fOccupancyRebinCmd->SetParameterName("rebin", false);
+  fOccupancyRebinCmd->SetRange("rebin>0");
+  fOccupancyRebinCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fModuleSizeCmd = new G4UIcommand("/out/moduleSize", this);
+  fModuleSizeCmd->SetGuidance("size of a read-out module (width along x, height along y) for the hits per module histograms");
+  G4UIparameter* widthParam = new G4UIparameter("width", 'd', false);
+  widthParam->SetParameterRange("width>0");
+  fModuleSizeCmd->SetParameter(widthParam);
+  G4UIparameter* heightParam = new G4UIparameter("height", 'd', false);
+  heightParam->SetParameterRange("height>0");
+  fModuleSizeCmd->SetParameter(heightParam);
+  G4UIparameter* unitParam = new G4UIparameter("unit", 's', true);
+  unitParam->SetDefaultValue("mm");
+  fModuleSizeCmd->SetParameter(unitParam);
+  fModuleSizeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -61,6 +123,16 @@ AnalysisManagerMessenger::~AnalysisManagerMessenger()
 {
   delete fFileCmd;
   delete fSaveTrackCmd;
+  delete fSaveActsCmd;
+  delete fSaveClustersCmd;
+  delete fClusterConnectivityCmd;
+  delete fDropRawHitsCmd;
+  delete fSaveTruthLinksCmd;
+  delete fSaveHitPositionsCmd;
+  delete fModeCmd;
+  delete fSaveOccupancyCmd;
+  delete fOccupancyRebinCmd;
+  delete fModuleSizeCmd;
   delete fOutDir;
 }
 
@@ -70,7 +142,47 @@ void AnalysisManagerMessenger::SetNewValue(G4UIcommand* command,G4String newValu
 {
   if (command == fFileCmd) fAnalysisManager->setFileName(newValues);
   if (command == fSaveTrackCmd) fAnalysisManager->saveTrack(fSaveTrackCmd->GetNewBoolValue(newValues));
+  if (command == fSaveActsCmd) fAnalysisManager->saveActs(fSaveActsCmd->GetNewBoolValue(newValues));
+  if (command == fSaveClustersCmd) fAnalysisManager->saveClusters(fSaveClustersCmd->GetNewBoolValue(newValues));
+  if (command == fClusterConnectivityCmd) fAnalysisManager->setClusterConnectivity(fClusterConnectivityCmd->GetNewIntValue(newValues));
+  if (command == fDropRawHitsCmd) fAnalysisManager->dropRawHits(fDropRawHitsCmd->GetNewBoolValue(newValues));
+  if (command == fSaveTruthLinksCmd) fAnalysisManager->saveTruthLinks(fSaveTruthLinksCmd->GetNewBoolValue(newValues));
+  if (command == fSaveHitPositionsCmd) fAnalysisManager->saveHitPositions(fSaveHitPositionsCmd->GetNewBoolValue(newValues));
+  if (command == fModeCmd) fAnalysisManager->setOutputMode(newValues);
+  if (command == fSaveOccupancyCmd) fAnalysisManager->saveOccupancy(fSaveOccupancyCmd->GetNewBoolValue(newValues));
+  if (command == fOccupancyRebinCmd) fAnalysisManager->setOccupancyRebin(fOccupancyRebinCmd->GetNewIntValue(newValues));
+  if (command == fModuleSizeCmd) {
+    G4double width, height;
+    G4String unit;
+    std::istringstream is(newValues);
+    is >> width >> height >> unit;
+    G4double value = G4UIcommand::ValueOf(unit);
+    fAnalysisManager->setModuleSize(width * value, height * value);
+  }
+
+}
 
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String AnalysisManagerMessenger::GetCurrentValue(G4UIcommand* command)
+{
+  if (command == fFileCmd) return fAnalysisManager->GetFileName();
+  if (command == fSaveTrackCmd) return fSaveTrackCmd->ConvertToString(fAnalysisManager->GetSaveTrack());
+  if (command == fSaveActsCmd) return fSaveActsCmd->ConvertToString(fAnalysisManager->GetSaveActs());
+  if (command == fSaveClustersCmd) return fSaveClustersCmd->ConvertToString(fAnalysisManager->GetSaveClusters());
+  if (command == fClusterConnectivityCmd) return fClusterConnectivityCmd->ConvertToString(fAnalysisManager->GetClusterConnectivity());
+  if (command == fDropRawHitsCmd) return fDropRawHitsCmd->ConvertToString(fAnalysisManager->GetDropRawHits());
+  if (command == fSaveTruthLinksCmd) return fSaveTruthLinksCmd->ConvertToString(fAnalysisManager->GetSaveTruthLinks());
+  if (command == fSaveHitPositionsCmd) return fSaveHitPositionsCmd->ConvertToString(fAnalysisManager->GetSaveHitPositions());
+  if (command == fModeCmd) return fAnalysisManager->GetOutputMode();
+  if (command == fSaveOccupancyCmd) return fSaveOccupancyCmd->ConvertToString(fAnalysisManager->GetSaveOccupancy());
+  if (command == fOccupancyRebinCmd) return fOccupancyRebinCmd->ConvertToString(fAnalysisManager->GetOccupancyRebin());
+  if (command == fModuleSizeCmd) {
+    std::ostringstream os;
+    os << fAnalysisManager->GetModuleWidth() / mm << " " << fAnalysisManager->GetModuleHeight() / mm << " mm";
+    return os.str();
+  }
+  return "";
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -9,8 +9,22 @@
 #include "G4PVReplica.hh"
 #include "G4PVParameterised.hh"
 #include "G4SDManager.hh"
-#include <fstream>
 #include "G4VisAttributes.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "StartupTimer.hh"
+#include "ContentHash.hh"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
+
+// Bump whenever Construct() changes the geometry for the same /det/ parameters,
+// so that geometries cached by older versions are not picked up.
+static const G4int kGeometryVersion = 1;
 
 DetectorConstruction::DetectorConstruction()
   : G4VUserDetectorConstruction()
@@ -24,11 +38,40 @@ DetectorConstruction::~DetectorConstruction()
 }
 
 G4VPhysicalVolume* DetectorConstruction::Construct()
+{
+  fTarget_phys.clear();
+  fPixelLV = nullptr;
+
+  // Overlap checking is a validation mode: always build from scratch then
+  G4String cacheFile;
+  if (!fCacheDir.empty() && !fCheckOverlaps) {
+    std::error_code ec;
+    std::filesystem::create_directories(fCacheDir.c_str(), ec);
+    cacheFile = fCacheDir + "/pinpoint-" + GeometryHash() + ".gdml";
+    std::ifstream cached(cacheFile);
+    if (cached.good()) {
+      cached.close();
+      G4VPhysicalVolume* worldPV = LoadGeometry(cacheFile);
+      StartupTimer::Mark("geometry loaded");
+      if (fExportGDML) WriteGDML(fWriteFile, worldPV);
+      return worldPV;
+    }
+  }
+
+  G4VPhysicalVolume* worldPV = BuildGeometry();
+  StartupTimer::Mark("geometry constructed");
+
+  if (!cacheFile.empty()) WriteGDML(cacheFile, worldPV);
+  if (fExportGDML) WriteGDML(fWriteFile, worldPV);
+  return worldPV;
+}
+
+G4VPhysicalVolume* DetectorConstruction::BuildGeometry()
 {
   // Geometry parameters
   // https://iopscience.iop.org/article/10.1088/1748-0221/20/02/C02015
   G4double boxThickness = fTungstenThickness - fSiliconThickness;
-  G4bool fCheckOverlaps = true;
+  if (fCheckOverlaps) G4cout << "Checking the geometry for overlaps" << G4endl;
   
   // G4int nPixelsX = 12788; // 20.8um pixel pitch
   // G4int nPixelsY = 8596;  // 22.8um pixel pitch
@@ -116,16 +159,57 @@ G4VPhysicalVolume* DetectorConstruction::Construct()
   // G4cout << "Detector consists of " << fNLayers << " layers of: [ " << fTungstenThickness / mm << "mm of " << tungstenMaterial->GetName() << " + " << fSiliconThickness / mm << "mm of "
   //        << siliconMaterial->GetName() <<  " + " << boxThickness / mm << "mm of " << worldMaterial->GetName() << " ] " << G4endl;
 
-  // // Write GDML file if it doesn't exist
-  // std::ifstream file(fWriteFile);
-  // if (!file.good()) {
-  //   fParser.Write(fWriteFile, worldPV);
-  // }
-  // file.close();
-  
   return worldPV;
 }
 
+G4String DetectorConstruction::GeometryHash() const
+{
+  // every parameter Construct() depends on, printed exactly
+  std::ostringstream key;
+  key << std::setprecision(17) << kGeometryVersion
+      << " " << fTungstenThickness << " " << fSiliconThickness << " " << fNLayers
+      << " " << fPixelHeight << " " << fPixelWidth
+      << " " << fDetectorWidth << " " << fDetectorHeight;
+
+  return ContentHash(key.str());
+}
+
+G4VPhysicalVolume* DetectorConstruction::LoadGeometry(const G4String& file)
+{
+  G4cout << "Reading cached geometry from " << file << G4endl;
+  fParser.Clear();
+  fParser.Read(file, false);
+  G4VPhysicalVolume* worldPV = fParser.GetWorldVolume();
+
+  // recover the handles Construct() keeps from the stores
+  fPixelLV = G4LogicalVolumeStore::GetInstance()->GetVolume("SiliconPixel", false);
+  G4VPhysicalVolume* tungstenPV = G4PhysicalVolumeStore::GetInstance()->GetVolume("Tungsten", false);
+  if (!worldPV || !fPixelLV || !tungstenPV) {
+    G4ExceptionDescription msg;
+    msg << "Cached geometry " << file << " does not contain the Pinpoint volumes, remove it to rebuild the cache";
+    G4Exception("DetectorConstruction::LoadGeometry", "Geometry001", FatalException, msg);
+  }
+  fTarget_phys.push_back(tungstenPV);
+  return worldPV;
+}
+
+void DetectorConstruction::WriteGDML(const G4String& file, G4VPhysicalVolume* worldPV)
+{
+  // the GDML writer refuses to overwrite, and parallel jobs may fill the
+  // cache at the same time: write a private file and move it into place
+  G4String tmpFile = file + ".tmp" + std::to_string(::getpid());
+  std::remove(tmpFile.c_str());
+  fParser.Write(tmpFile, worldPV, false);
+  if (std::rename(tmpFile.c_str(), file.c_str()) != 0) {
+    G4ExceptionDescription msg;
+    msg << "Could not write the geometry to " << file;
+    G4Exception("DetectorConstruction::WriteGDML", "Geometry002", JustWarning, msg);
+    std::remove(tmpFile.c_str());
+    return;
+  }
+  G4cout << "Geometry written to " << file << G4endl;
+}
+
 void DetectorConstruction::ConstructSDandField()
 {
   if (fPixelLV) {
@@ -73,6 +73,23 @@ DetectorConstructionMessenger::DetectorConstructionMessenger(DetectorConstructio
     detGdmlCmd->SetParameterName("GDMLFile", false);
     detGdmlCmd->SetDefaultValue("pinpoint.gdml");
 
+    detExportGdmlCmd = new G4UIcmdWithABool("/det/exportGDML", this);
+    detExportGdmlCmd->SetGuidance("Write the constructed geometry to the file set with /det/setGDMLFile.");
+    detExportGdmlCmd->SetParameterName("exportGDML", true);
+    detExportGdmlCmd->SetDefaultValue(true);
+
+    detCacheCmd = new G4UIcmdWithAString("/det/geometryCache", this);
+    detCacheCmd->SetGuidance("Directory of GDML files keyed by a hash of the /det/ parameters.");
+    detCacheCmd->SetGuidance("A cached geometry is read instead of being built; a missing one is built and added.");
+    detCacheCmd->SetParameterName("cacheDir", false);
+    detCacheCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+    detCheckOverlapCmd = new G4UIcmdWithABool("/det/checkOverlaps", this);
+    detCheckOverlapCmd->SetGuidance("Check every placement for overlaps when building the geometry (slow, validation only).");
+    detCheckOverlapCmd->SetGuidance("The geometry cache is bypassed while checking.");
+    detCheckOverlapCmd->SetParameterName("checkOverlaps", true);
+    detCheckOverlapCmd->SetDefaultValue(true);
+
     // magnetFieldCmd = new G4UIcmdWithADoubleAndUnit("/det/magnetField", this);
     // magnetFieldCmd->SetUnitCategory("Magnetic flux density");
     // magnetFieldCmd->SetDefaultUnit("tesla");
@@ -94,6 +111,9 @@ DetectorConstructionMessenger::~DetectorConstructionMessenger() {
   delete detectorWidthCmd;
   delete detectorHeightCmd;
   delete detGdmlCmd;
+  delete detExportGdmlCmd;
+  delete detCacheCmd;
+  delete detCheckOverlapCmd;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -132,6 +152,9 @@ void DetectorConstructionMessenger::SetNewValue(G4UIcommand* command, G4String n
     // G4String filename = detGdmlCmd->GetNewStringValue(newValues);
     det->SetGDMLFile(newValues);
   }
+  if (command == detExportGdmlCmd) det->SetExportGDML(detExportGdmlCmd->GetNewBoolValue(newValues));
+  if (command == detCacheCmd) det->SetGeometryCache(newValues);
+  if (command == detCheckOverlapCmd) det->SetCheckOverlaps(detCheckOverlapCmd->GetNewBoolValue(newValues));
 
 //   if (command == detGdmlCmd) det->SaveGDML(detGdmlCmd->GetNewBoolValue(newValues));
     // if (command == magnetFieldCmd) { 
@@ -141,4 +164,21 @@ void DetectorConstructionMessenger::SetNewValue(G4UIcommand* command, G4String n
     //   }; 
 }
 
-//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
\ No newline at end of file
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String DetectorConstructionMessenger::GetCurrentValue(G4UIcommand* command) {
+  if (command == tungstenThicknessCmd) return tungstenThicknessCmd->ConvertToString(det->GetTungstenThickness(), "mm");
+  if (command == siliconThicknessCmd) return siliconThicknessCmd->ConvertToString(det->GetSiliconThickness(), "um");
+  if (command == nLayersCmd) return nLayersCmd->ConvertToString(det->GetNlayers());
+  if (command == pixelHeightCmd) return pixelHeightCmd->ConvertToString(det->GetPixelHeight(), "um");
+  if (command == pixelWidthCmd) return pixelWidthCmd->ConvertToString(det->GetPixelWidth(), "um");
+  if (command == detectorWidthCmd) return detectorWidthCmd->ConvertToString(det->GetDetectorWidth(), "cm");
+  if (command == detectorHeightCmd) return detectorHeightCmd->ConvertToString(det->GetDetectorHeight(), "cm");
+  if (command == detGdmlCmd) return det->GetGDMLFile();
+  if (command == detExportGdmlCmd) return detExportGdmlCmd->ConvertToString(det->GetExportGDML());
+  if (command == detCacheCmd) return det->GetGeometryCache();
+  if (command == detCheckOverlapCmd) return detCheckOverlapCmd->ConvertToString(det->GetCheckOverlaps());
+  return "";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
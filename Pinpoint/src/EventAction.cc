@@ -6,6 +6,9 @@
 #include "G4Circle.hh"
 #include "G4VisAttributes.hh"
 #include "AnalysisManager.hh"
+#include "StartupTimer.hh"
+#include "PixelDigitizer.hh"
+#include "G4DigiManager.hh"
 
 using namespace std;
 
@@ -26,6 +29,8 @@ EventAction::~EventAction() {;}
 
 void EventAction::BeginOfEventAction(const G4Event* event)
 {
+  StartupTimer::MarkFirstEvent();
+
   // Reset all accumulables to their initial values
   G4AccumulableManager* accumulableManager = G4AccumulableManager::Instance();
   accumulableManager->Reset();
@@ -57,6 +62,10 @@ void EventAction::EndOfEventAction(const G4Event* event)
   if(!fNPrimaryTrack.GetValue() && !fNSecondaryTrack.GetValue() && !fNSecondaryTrackNotGamma.GetValue()) 
     return;
 
+  G4DigiManager* digiManager = G4DigiManager::GetDMpointer();
+  auto digitizer = static_cast<PixelDigitizer*>(digiManager->FindDigitizerModule("PixelDigitizer"));
+  if (digitizer && digitizer->IsEnabled()) digiManager->Digitize("PixelDigitizer");
+
   AnalysisManager* ana = AnalysisManager::GetInstance();
   ana->EndOfEvent(event);
 
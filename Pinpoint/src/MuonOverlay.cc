@@ -0,0 +1,234 @@
+#include "MuonOverlay.hh"
+#include "MuonOverlayMessenger.hh"
+#include "DetectorConstruction.hh"
+#include "PixelGeometry.hh"
+#include "SeedService.hh"
+
+#include "G4RunManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Exception.hh"
+#include "CLHEP/Random/RandFlat.h"
+#include "CLHEP/Random/RandPoissonQ.h"
+
+#include "TDirectory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+MuonOverlay* MuonOverlay::fInstance = nullptr;
+
+MuonOverlay* MuonOverlay::GetInstance()
+{
+  if (!fInstance) fInstance = new MuonOverlay();
+  return fInstance;
+}
+
+MuonOverlay::MuonOverlay()
+{
+  fMessenger = new MuonOverlayMessenger(this);
+
+  fRate = 0.;
+  fMaxShift = 1*cm;
+  fSeed = 0;
+  fWriteFile = nullptr;
+  fWriteTree = nullptr;
+  fPixelWidth = fPixelHeight = 0.;
+  fNPixelsX = fNPixelsY = 0;
+  fNOverlaid = 0;
+}
+
+MuonOverlay::~MuonOverlay()
+{
+  delete fMessenger;
+}
+
+void MuonOverlay::BeginOfRun()
+{
+  auto detector = (const DetectorConstruction*) (G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  fPixelWidth = detector->GetPixelWidth();
+  fPixelHeight = detector->GetPixelHeight();
+  fNPixelsX = detector->GetNPixelsX();
+  fNPixelsY = detector->GetNPixelsY();
+  fNOverlaid = 0;
+
+  if (!fWriteFilename.empty()) {
+    // keep the current directory, the analysis output is written there
+    TDirectory::TContext context;
+    fWriteFile = new TFile(fWriteFilename.c_str(), "RECREATE");
+    fWriteTree = new TTree("muonHits", "pixel hits of single muon events");
+    fWriteTree->Branch("layer", &fLayer);
+    fWriteTree->Branch("row", &fRow);
+    fWriteTree->Branch("col", &fCol);
+    fWriteTree->Branch("pdg", &fPDG);
+    fWriteTree->Branch("charge", &fCharge);
+    fWriteTree->Branch("edep", &fEdep);   // MeV
+    fWriteTree->Branch("px", &fPx);       // MeV
+    fWriteTree->Branch("py", &fPy);
+    fWriteTree->Branch("pz", &fPz);
+    fWriteTree->Branch("E", &fE);
+    G4cout << "MuonOverlay: writing the pixel hits of each event to the muon library " << fWriteFilename << G4endl;
+  }
+
+  if (!fReadFilename.empty() && fRate > 0.) {
+    if (fReadFilename != fLoadedFilename) LoadLibrary();
+    G4cout << "MuonOverlay: overlaying Poisson(" << fRate << ") muons per event from " << fOffsets.size()-1 
+           << " library entries, shifted by up to " << fMaxShift/mm << " mm" << G4endl;
+  }
+}
+
+void MuonOverlay::EndOfRun()
+{
+  if (fWriteFile) {
+    TDirectory::TContext context;
+    fWriteFile->cd();
+    G4cout << "MuonOverlay: " << fWriteTree->GetEntries() << " entries written to the muon library" << G4endl;
+    fWriteTree->Write();
+    fWriteFile->Close();
+    delete fWriteFile;
+    fWriteFile = nullptr;
+    fWriteTree = nullptr;
+  }
+  if (fNOverlaid > 0) G4cout << "MuonOverlay: " << fNOverlaid << " muons overlaid in this run" << G4endl;
+}
+
+void MuonOverlay::EndOfEvent(PixelHitsCollection* hits, G4long eventIndex)
+{
+  fDeposits.clear();
+  if (fWriteTree) WriteEntry(hits);
+  if (!fOffsets.empty() && fRate > 0.) Overlay(hits, eventIndex);
+}
+
+void MuonOverlay::WriteEntry(const PixelHitsCollection* hits)
+{
+  for (auto* v : {&fLayer, &fRow, &fCol, &fPDG, &fCharge}) v->clear();
+  for (auto* v : {&fEdep, &fPx, &fPy, &fPz, &fE}) v->clear();
+
+  for (std::size_t i = 0; i < hits->entries(); ++i) {
+    const PixelHit* hit = (*hits)[i];
+    fLayer.push_back(hit->GetLayerID());
+    fRow.push_back(hit->GetRowID());
+    fCol.push_back(hit->GetColID());
+    fPDG.push_back(hit->GetPDGCode());
+    fCharge.push_back(hit->GetCharge());
+    fEdep.push_back(hit->GetEnergyDeposit());
+    fPx.push_back(hit->GetPx());
+    fPy.push_back(hit->GetPy());
+    fPz.push_back(hit->GetPz());
+    fE.push_back(hit->GetEnergy());
+  }
+  fWriteTree->Fill();
+}
+
+void MuonOverlay::LoadLibrary()
+{
+  TDirectory::TContext context;
+  TFile file(fReadFilename.c_str(), "READ");
+  TTree* tree = file.IsOpen() ? (TTree*)file.Get("muonHits") : nullptr;
+  if (!tree) {
+    G4String err = "Cannot read muon library : " + fReadFilename;
+    G4Exception("MuonOverlay", "FileError", FatalErrorInArgument, err.c_str());
+    return;
+  }
+
+  std::vector<int>* layer = nullptr, *row = nullptr, *col = nullptr, *pdg = nullptr, *charge = nullptr;
+  std::vector<float>* edep = nullptr, *px = nullptr, *py = nullptr, *pz = nullptr, *e = nullptr;
+  tree->SetBranchAddress("layer", &layer);
+  tree->SetBranchAddress("row", &row);
+  tree->SetBranchAddress("col", &col);
+  tree->SetBranchAddress("pdg", &pdg);
+  tree->SetBranchAddress("charge", &charge);
+  tree->SetBranchAddress("edep", &edep);
+  tree->SetBranchAddress("px", &px);
+  tree->SetBranchAddress("py", &py);
+  tree->SetBranchAddress("pz", &pz);
+  tree->SetBranchAddress("E", &e);
+
+  // flatten the library: sampling an entry is then a slice of fHits
+  fHits.clear();
+  fOffsets.assign(1, 0);
+  for (Long64_t i = 0; i < tree->GetEntries(); ++i) {
+    tree->GetEntry(i);
+    for (std::size_t j = 0; j < layer->size(); ++j) {
+      fHits.push_back({(*layer)[j], (*row)[j], (*col)[j], (*pdg)[j], (*charge)[j],
+                       (*edep)[j], (*px)[j], (*py)[j], (*pz)[j], (*e)[j]});
+    }
+    fOffsets.push_back(fHits.size());
+  }
+  tree->ResetBranchAddresses();
+  for (auto* v : {layer, row, col, pdg, charge}) delete v;
+  for (auto* v : {edep, px, py, pz, e}) delete v;
+
+  if (fOffsets.size() < 2) {
+    G4String err = "Muon library is empty : " + fReadFilename;
+    G4Exception("MuonOverlay", "FileError", FatalErrorInArgument, err.c_str());
+  }
+  fLoadedFilename = fReadFilename;
+  G4cout << "MuonOverlay: loaded " << fOffsets.size()-1 << " muons with " << fHits.size() 
+         << " hits from " << fReadFilename << G4endl;
+}
+
+void MuonOverlay::Overlay(PixelHitsCollection* hits, G4long eventIndex)
+{
+  // own engine reseeded per event: the overlay does not change the Geant4 random sequence
+  // and is the same for an event whatever happened before it
+  std::uint64_t seed = SeedService::GetInstance()->StreamSeed(SeedService::kOverlayStream, fSeed, eventIndex);
+  fEngine.setSeed(static_cast<long>(seed >> 1), 0);
+
+  G4long nMuons = CLHEP::RandPoissonQ::shoot(&fEngine, fRate);
+  if (nMuons == 0) return;
+
+  // pixels already hit in the signal event
+  std::unordered_map<std::uint64_t, PixelHit*> pixels;
+  for (std::size_t i = 0; i < hits->entries(); ++i) {
+    PixelHit* hit = (*hits)[i];
+    pixels[PixelGeometry::Key(hit->GetLayerID(), hit->GetRowID(), hit->GetColID())] = hit;
+  }
+
+  std::size_t nLibrary = fOffsets.size() - 1;
+  for (G4long k = 0; k < nMuons; ++k) {
+    std::size_t entry = std::min<std::size_t>(CLHEP::RandFlat::shootInt(&fEngine, nLibrary), nLibrary-1);
+    G4int dRow = static_cast<G4int>(std::lround(CLHEP::RandFlat::shoot(&fEngine, -fMaxShift, fMaxShift) / fPixelWidth));
+    G4int dCol = static_cast<G4int>(std::lround(CLHEP::RandFlat::shoot(&fEngine, -fMaxShift, fMaxShift) / fPixelHeight));
+    G4int trackID = -1 - static_cast<G4int>(k);
+
+    for (std::uint64_t i = fOffsets[entry]; i < fOffsets[entry+1]; ++i) {
+      const LibraryHit& libHit = fHits[i];
+      G4int row = libHit.row + dRow;
+      G4int col = libHit.col + dCol;
+      if (row < 0 || row >= fNPixelsX || col < 0 || col >= fNPixelsY) continue; // shifted out of the detector
+
+      G4LorentzVector p4(libHit.px, libHit.py, libHit.pz, libHit.e);
+      std::uint64_t key = PixelGeometry::Key(libHit.layer, row, col);
+      fDeposits.push_back({key, libHit.edep, trackID});
+      auto it = pixels.find(key);
+      if (it != pixels.end()) {
+        // shared pixel: charges add up, the truth follows the most energetic particle (as in PixelSD)
+        PixelHit* hit = it->second;
+        hit->SetEnergyDeposit(hit->GetEnergyDeposit() + libHit.edep);
+        hit->SetFromMuon(true);
+        if (p4.e() > hit->GetEnergy()) {
+          hit->SetTrackID(trackID);
+          hit->SetPDGCode(libHit.pdg);
+          hit->SetCharge(libHit.charge);
+          hit->SetP4(p4);
+        }
+        continue;
+      }
+
+      auto newHit = new PixelHit();
+      newHit->SetLayerID(libHit.layer);
+      newHit->SetRowID(row);
+      newHit->SetColID(col);
+      newHit->SetP4(p4);
+      newHit->SetCharge(libHit.charge);
+      newHit->SetTrackID(trackID);
+      newHit->SetPDGCode(libHit.pdg);
+      newHit->SetEnergyDeposit(libHit.edep);
+      newHit->SetFromMuon(true);
+      hits->insert(newHit);
+      pixels[key] = newHit;
+    }
+  }
+  fNOverlaid += nMuons;
+}
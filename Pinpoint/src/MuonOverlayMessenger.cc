@@ -0,0 +1,83 @@
+#include "MuonOverlayMessenger.hh"
+
+#include "MuonOverlay.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithAnInteger.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MuonOverlayMessenger::MuonOverlayMessenger(MuonOverlay* overlay)
+  : fOverlay(overlay)
+{
+  fOverlayDir = new G4UIdirectory("/overlay/");
+  fOverlayDir->SetGuidance("muon background overlay control");
+
+  fWriteLibraryCmd = new G4UIcmdWithAString("/overlay/writeLibrary", this);
+  fWriteLibraryCmd->SetGuidance("write the pixel hits of every event to a muon library file (for muon-only runs)");
+  fWriteLibraryCmd->SetParameterName("fileName", false);
+  fWriteLibraryCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fLibraryCmd = new G4UIcmdWithAString("/overlay/library", this);
+  fLibraryCmd->SetGuidance("set the muon library overlaid on each event");
+  fLibraryCmd->SetParameterName("fileName", false);
+  fLibraryCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fRateCmd = new G4UIcmdWithADouble("/overlay/rate", this);
+  fRateCmd->SetGuidance("set the mean number of overlaid muons per event (Poisson distributed, 0 disables the overlay)");
+  fRateCmd->SetParameterName("rate", false);
+  fRateCmd->SetRange("rate>=0");
+  fRateCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fMaxShiftCmd = new G4UIcmdWithADoubleAndUnit("/overlay/maxShift", this);
+  fMaxShiftCmd->SetGuidance("overlaid muons are shifted uniformly within +-maxShift in x and y");
+  fMaxShiftCmd->SetParameterName("maxShift", false);
+  fMaxShiftCmd->SetRange("maxShift>=0");
+  fMaxShiftCmd->SetUnitCategory("Length");
+  fMaxShiftCmd->SetDefaultUnit("cm");
+  fMaxShiftCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fSeedCmd = new G4UIcmdWithAnInteger("/overlay/seed", this);
+  fSeedCmd->SetGuidance("set the seed of the overlay sampling, combined with /random/masterSeed and the index of each event in the sample");
+  fSeedCmd->SetParameterName("seed", false);
+  fSeedCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+MuonOverlayMessenger::~MuonOverlayMessenger()
+{
+  delete fWriteLibraryCmd;
+  delete fLibraryCmd;
+  delete fRateCmd;
+  delete fMaxShiftCmd;
+  delete fSeedCmd;
+  delete fOverlayDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void MuonOverlayMessenger::SetNewValue(G4UIcommand* command, G4String newValues)
+{
+  if (command == fWriteLibraryCmd) fOverlay->SetWriteLibrary(newValues);
+  else if (command == fLibraryCmd) fOverlay->SetLibrary(newValues);
+  else if (command == fRateCmd) fOverlay->SetRate(fRateCmd->GetNewDoubleValue(newValues));
+  else if (command == fMaxShiftCmd) fOverlay->SetMaxShift(fMaxShiftCmd->GetNewDoubleValue(newValues));
+  else if (command == fSeedCmd) fOverlay->SetSeed(fSeedCmd->GetNewIntValue(newValues));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String MuonOverlayMessenger::GetCurrentValue(G4UIcommand* command)
+{
+  if (command == fWriteLibraryCmd) return fOverlay->GetWriteLibrary();
+  if (command == fLibraryCmd) return fOverlay->GetLibrary();
+  if (command == fRateCmd) return fRateCmd->ConvertToString(fOverlay->GetRate());
+  if (command == fMaxShiftCmd) return fMaxShiftCmd->ConvertToString(fOverlay->GetMaxShift(), "cm");
+  if (command == fSeedCmd) return fSeedCmd->ConvertToString(static_cast<G4int>(fOverlay->GetSeed()));
+  return "";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
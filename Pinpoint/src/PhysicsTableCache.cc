@@ -0,0 +1,188 @@
+#include "PhysicsTableCache.hh"
+#include "PhysicsTableCacheMessenger.hh"
+#include "ContentHash.hh"
+
+#include "G4StateManager.hh"
+#include "G4RunManagerKernel.hh"
+#include "G4VUserPhysicsList.hh"
+#include "G4Material.hh"
+#include "G4Element.hh"
+#include "G4RegionStore.hh"
+#include "G4Region.hh"
+#include "G4ProductionCuts.hh"
+#include "G4ProductionCutsTable.hh"
+#include "G4Version.hh"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+PhysicsTableCache* PhysicsTableCache::fInstance = nullptr;
+
+static const char* kKeyFile = "key.txt";
+
+// data sets the tables are built from; their directory names carry the versions
+static const char* kDataSets[] = {"G4LEDATA", "G4LEVELGAMMADATA", "G4NEUTRONHPDATA", "G4PARTICLEHPDATA",
+                                  "G4NEUTRONXSDATA", "G4PARTICLEXSDATA", "G4PIIDATA", "G4RADIOACTIVEDATA",
+                                  "G4REALSURFACEDATA", "G4SAIDXSDATA", "G4ABLADATA", "G4INCLDATA",
+                                  "G4ENSDFSTATEDATA", "G4CHANNELINGDATA"};
+
+PhysicsTableCache* PhysicsTableCache::GetInstance()
+{
+  if (!fInstance) fInstance = new PhysicsTableCache();
+  return fInstance;
+}
+
+PhysicsTableCache::PhysicsTableCache()
+  : G4VStateDependent(), fPhysicsListName("unknown"), fFirstRun(true), fStore(false)
+{
+  fMessenger = new PhysicsTableCacheMessenger(this);
+}
+
+PhysicsTableCache::~PhysicsTableCache()
+{
+  delete fMessenger;
+}
+
+G4bool PhysicsTableCache::Notify(G4ApplicationState requestedState)
+{
+  // the state has not changed yet while observers are notified
+  G4ApplicationState currentState = G4StateManager::GetStateManager()->GetCurrentState();
+
+  if (currentState == G4State_Idle && requestedState == G4State_Init) Prepare();
+  else if (currentState == G4State_Init && requestedState == G4State_Idle && fStore) Store();
+  return true;
+}
+
+G4String PhysicsTableCache::CacheKey() const
+{
+  std::ostringstream key;
+  key.precision(17);
+  key << "geant4 " << G4VERSION_NUMBER << "\n"
+      << "physics " << fPhysicsListName << "\n";
+
+  for (const char* dataSet : kDataSets) {
+    const char* path = std::getenv(dataSet);
+    if (!path) continue;
+    // e.g. .../G4EMLOW8.5, the installation prefix does not matter
+    std::filesystem::path dir = std::filesystem::path(path).lexically_normal();
+    if (dir.filename().empty()) dir = dir.parent_path();
+    key << "data " << dataSet << " " << dir.filename().string() << "\n";
+  }
+
+  G4VUserPhysicsList* physics = G4RunManagerKernel::GetRunManagerKernel()->GetPhysicsList();
+  G4ProductionCutsTable* cutsTable = G4ProductionCutsTable::GetProductionCutsTable();
+  key << "defaultCut " << physics->GetDefaultCutValue()
+      << " energyRange " << cutsTable->GetLowEdgeEnergy() << " " << cutsTable->GetHighEdgeEnergy() << "\n";
+
+  for (const G4Material* material : *G4Material::GetMaterialTable()) {
+    key << "material " << material->GetName() << " " << material->GetDensity()
+        << " " << material->GetState() << " " << material->GetTemperature() << " " << material->GetPressure();
+    const G4double* fractions = material->GetFractionVector();
+    for (std::size_t i = 0; i < material->GetNumberOfElements(); ++i) {
+      key << " " << material->GetElement(i)->GetName() << ":" << fractions[i];
+    }
+    key << "\n";
+  }
+
+  for (const G4Region* region : *G4RegionStore::GetInstance()) {
+    key << "region " << region->GetName();
+    const G4ProductionCuts* cuts = region->GetProductionCuts();
+    if (cuts) {
+      for (const G4double cut : cuts->GetProductionCuts()) key << " " << cut;
+    }
+    key << "\n";
+  }
+  return key.str();
+}
+
+G4bool PhysicsTableCache::IsComplete(const G4String& entry, const G4String& key) const
+{
+  // the key file is written last and must match the whole key
+  std::ifstream in(entry + "/" + kKeyFile);
+  if (!in.good()) return false;
+  std::ostringstream stored;
+  stored << in.rdbuf();
+  return stored.str() == key;
+}
+
+void PhysicsTableCache::Prepare()
+{
+  G4VUserPhysicsList* physics = G4RunManagerKernel::GetRunManagerKernel()->GetPhysicsList();
+  fStore = false;
+  if (fDirectory.empty()) {
+    fFirstRun = false;
+    return;
+  }
+
+  // only the tables of the first run of a job are cached: later rebuilds
+  // (/run/physicsModified, changed cuts) always start from scratch
+  if (!fFirstRun) {
+    physics->ResetPhysicsTableRetrieved();
+    return;
+  }
+  fFirstRun = false;
+
+  fKey = CacheKey();
+  fEntry = fDirectory + "/" + fPhysicsListName + "-" + ContentHash(fKey);
+
+  if (IsComplete(fEntry, fKey)) {
+    G4cout << "PhysicsTableCache: retrieving physics tables from " << fEntry << G4endl;
+    physics->SetPhysicsTableRetrieved(fEntry);
+  }
+  else {
+    G4cout << "PhysicsTableCache: no cached physics tables, they will be stored in " << fEntry << G4endl;
+    physics->ResetPhysicsTableRetrieved();
+  }
+  fStore = true;
+}
+
+void PhysicsTableCache::Store()
+{
+  fStore = false;
+  G4VUserPhysicsList* physics = G4RunManagerKernel::GetRunManagerKernel()->GetPhysicsList();
+
+  // retrieved tables are kept; Geant4 falls back to building them if the
+  // stored material-cuts couples do not match
+  if (physics->IsPhysicsTableRetrieved()) return;
+
+  // a complete entry may be read by another job right now and is never
+  // replaced, e.g. when it was stored while this job built its tables
+  if (IsComplete(fEntry, fKey)) {
+    G4cout << "PhysicsTableCache: physics tables already stored in " << fEntry << G4endl;
+    return;
+  }
+
+  namespace fs = std::filesystem;
+  std::error_code ec;
+  fs::path entry(fEntry.c_str());
+  fs::path tmp(fEntry + ".tmp" + std::to_string(::getpid()));
+  fs::remove_all(tmp, ec);
+  fs::create_directories(tmp, ec);
+
+  G4bool stored = !ec && physics->StorePhysicsTable(tmp.string());
+  if (stored) {
+    std::ofstream out(tmp / kKeyFile);
+    out << fKey;
+    stored = out.good();
+  }
+  if (stored) {
+    // only an incomplete entry (e.g. of an interrupted job) is removed; the
+    // rename fails if another job has put a complete one in place since
+    if (!IsComplete(fEntry, fKey)) fs::remove_all(entry, ec);
+    fs::rename(tmp, entry, ec);
+    stored = !ec || IsComplete(fEntry, fKey);
+  }
+  fs::remove_all(tmp, ec);
+
+  if (stored) {
+    G4cout << "PhysicsTableCache: physics tables stored in " << fEntry << G4endl;
+  }
+  else {
+    G4ExceptionDescription msg;
+    msg << "Could not store the physics tables in " << fEntry;
+    G4Exception("PhysicsTableCache::Store", "PhysicsCache001", JustWarning, msg);
+  }
+}
@@ -0,0 +1,41 @@
+#include "PhysicsTableCacheMessenger.hh"
+
+#include "PhysicsTableCache.hh"
+#include "G4UIcmdWithAString.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsTableCacheMessenger::PhysicsTableCacheMessenger(PhysicsTableCache* cache)
+  : fCache(cache)
+{
+  // the /run/ directory is created by the Geant4 run manager
+  fDirectoryCmd = new G4UIcmdWithAString("/run/physicsTableCache", this);
+  fDirectoryCmd->SetGuidance("directory of cached physics tables, keyed by physics list, materials and cuts");
+  fDirectoryCmd->SetGuidance("tables found there are retrieved instead of built, missing ones are stored after building");
+  fDirectoryCmd->SetParameterName("dir", false);
+  fDirectoryCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PhysicsTableCacheMessenger::~PhysicsTableCacheMessenger()
+{
+  delete fDirectoryCmd;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PhysicsTableCacheMessenger::SetNewValue(G4UIcommand* command, G4String newValues)
+{
+  if (command == fDirectoryCmd) fCache->SetDirectory(newValues);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String PhysicsTableCacheMessenger::GetCurrentValue(G4UIcommand* command)
+{
+  if (command == fDirectoryCmd) return fCache->GetDirectory();
+  return "";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,14 @@
+#include "PixelDigi.hh"
+
+#include <iomanip>
+
+G4ThreadLocal G4Allocator<PixelDigi>* PixelDigiAllocator = nullptr;
+
+void PixelDigi::Print()
+{
+  G4cout
+     << "  layer: " << fLayerID
+     << "  pixel(" << fRowID << "," << fColID << ")"
+     << "  Charge: " << std::setw(7) << fCharge << " e"
+     << G4endl;
+}
@@ -0,0 +1,201 @@
+#include "PixelDigitizer.hh"
+#include "PixelDigitizerMessenger.hh"
+#include "PixelDigi.hh"
+#include "PixelSD.hh"
+#include "DetectorConstruction.hh"
+#include "PixelGeometry.hh"
+
+#include "G4SDManager.hh"
+#include "G4RunManager.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Poisson.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+  const G4double kPairEnergy = 3.62 * eV;   // mean energy per electron-hole pair in silicon
+  const G4int kMaxPointsPerStep = 32;
+  const G4double kMinFraction = 1e-4;       // smaller shares of a point are dropped
+
+  // tabulated standard normal CDF on [-kCdfRange, kCdfRange]
+  const G4double kCdfRange = 6.;
+  const G4int kCdfBins = 4096;
+
+  // standard normal beyond a > 0 (Marsaglia's tail method)
+  G4double NormalTail(G4double a)
+  {
+    G4double x, y;
+    do {
+      x = -std::log(G4UniformRand()) / a;
+      y = -std::log(G4UniformRand());
+    } while (2. * y < x * x);
+    return a + x;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PixelDigitizer::PixelDigitizer(const G4String& name)
+  : G4VDigitizerModule(name), fDiffusion(5. * um)
+{
+  collectionName.push_back("PixelDigits");
+  fMessenger = new PixelDigitizerMessenger(this);
+
+  fCdfTable.resize(kCdfBins + 1);
+  for (G4int i = 0; i <= kCdfBins; i++) {
+    G4double t = -kCdfRange + 2. * kCdfRange * i / kCdfBins;
+    fCdfTable[i] = 0.5 * std::erfc(-t / std::sqrt(2.));
+  }
+}
+
+PixelDigitizer::~PixelDigitizer()
+{
+  delete fMessenger;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4double PixelDigitizer::NormalCdf(G4double t) const
+{
+  G4double u = (t + kCdfRange) * (kCdfBins / (2. * kCdfRange));
+  u = std::min(std::max(u, 0.), kCdfBins - 1e-9);
+  G4int i = static_cast<G4int>(u);
+  G4double f = u - i;
+  return fCdfTable[i] + f * (fCdfTable[i + 1] - fCdfTable[i]);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PixelDigitizer::Digitize()
+{
+  if (!fEnabled) return;
+
+  auto digits = new PixelDigiCollection(GetName(), collectionName[0]);
+  auto sd = dynamic_cast<PixelSD*>(G4SDManager::GetSDMpointer()->FindSensitiveDetector("PixelDetector", false));
+  auto detector = static_cast<const DetectorConstruction*>(G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  if (!sd) {
+    StoreDigiCollection(digits);
+    return;
+  }
+  const PixelDeposits& deposits = sd->GetDeposits();
+
+  // the silicon layer frame shares x and y with the global one
+  const PixelGeometry geometry = detector->GetPixelGeometry();
+  const G4double pitchX = geometry.GetPitchX();
+  const G4double pitchY = geometry.GetPitchY();
+  const G4int nX = geometry.GetNRows();
+  const G4int nY = geometry.GetNCols();
+  const G4int nLayers = geometry.GetNLayers();
+  const G4double thickness = detector->GetSiliconThickness();
+  const G4double halfX = -geometry.X(0) + 0.5 * pitchX;
+  const G4double halfY = -geometry.Y(0) + 0.5 * pitchY;
+
+  //------------------------------------------------
+  // 1. charge points along every step, collected on the +z face
+  const G4double maxSpacing = 0.25 * std::min(pitchX, pitchY);
+  fPointX.clear(); fPointY.clear(); fPointSigma.clear(); fPointCharge.clear(); fPointLayer.clear();
+  for (std::size_t i = 0; i < deposits.size(); i++) {
+    G4double dx = deposits.x1[i] - deposits.x0[i];
+    G4double dy = deposits.y1[i] - deposits.y0[i];
+    G4double dz = deposits.z1[i] - deposits.z0[i];
+    G4int nPoints = std::clamp(static_cast<G4int>(std::ceil(std::hypot(dx, dy) / maxSpacing)), 1, kMaxPointsPerStep);
+    G4double charge = deposits.edep[i] / kPairEnergy / nPoints;
+    for (G4int k = 0; k < nPoints; k++) {
+      G4double f = (k + 0.5) / nPoints;
+      G4double drift = std::clamp(0.5 * thickness - (deposits.z0[i] + f * dz), 0., thickness);
+      fPointX.push_back(deposits.x0[i] + f * dx);
+      fPointY.push_back(deposits.y0[i] + f * dy);
+      fPointSigma.push_back(fDiffusion * std::sqrt(drift / thickness));
+      fPointCharge.push_back(charge);
+      fPointLayer.push_back(deposits.layer[i]);
+    }
+  }
+
+  //------------------------------------------------
+  // 2. share every point between its pixel and the neighbours: the fraction
+  // left of the pixel is Phi(a), inside Phi(b) - Phi(a), right of it 1 - Phi(b).
+  // Charge diffusing further than the first neighbours is dropped, which is
+  // negligible as long as the diffusion width stays below about half a pitch.
+  const std::size_t nPoints = fPointX.size();
+  fPointIx.resize(nPoints); fPointIy.resize(nPoints);
+  fAx.resize(nPoints); fBx.resize(nPoints); fAy.resize(nPoints); fBy.resize(nPoints);
+  for (std::size_t i = 0; i < nPoints; i++) {
+    G4double u = (fPointX[i] + halfX) / pitchX;
+    G4double v = (fPointY[i] + halfY) / pitchY;
+    G4int ix = static_cast<G4int>(std::floor(u));
+    G4int iy = static_cast<G4int>(std::floor(v));
+    // distances to the pixel edges in units of sigma; a zero width puts
+    // everything in the pixel of the point
+    G4double invSigma = fPointSigma[i] > 0. ? 1. / fPointSigma[i] : 1e12;
+    fPointIx[i] = ix;
+    fPointIy[i] = iy;
+    fAx[i] = NormalCdf(-(u - ix) * pitchX * invSigma);
+    fBx[i] = NormalCdf((ix + 1 - u) * pitchX * invSigma);
+    fAy[i] = NormalCdf(-(v - iy) * pitchY * invSigma);
+    fBy[i] = NormalCdf((iy + 1 - v) * pitchY * invSigma);
+  }
+
+  fPixelCharges.clear();
+  fPixelCharges.reserve(4 * nPoints);
+  for (std::size_t i = 0; i < nPoints; i++) {
+    const G4double fx[3] = {fAx[i], fBx[i] - fAx[i], 1. - fBx[i]};
+    const G4double fy[3] = {fAy[i], fBy[i] - fAy[i], 1. - fBy[i]};
+    for (G4int a = 0; a < 3; a++) {
+      G4int ix = fPointIx[i] + a - 1;
+      if (fx[a] < kMinFraction || ix < 0 || ix >= nX) continue;
+      for (G4int b = 0; b < 3; b++) {
+        G4int iy = fPointIy[i] + b - 1;
+        G4double f = fx[a] * fy[b];
+        if (f < kMinFraction || iy < 0 || iy >= nY) continue;
+        fPixelCharges.emplace_back(PixelGeometry::Key(fPointLayer[i], ix, iy), fPointCharge[i] * f);
+      }
+    }
+  }
+
+  //------------------------------------------------
+  // 3. sum per pixel
+  std::sort(fPixelCharges.begin(), fPixelCharges.end(),
+            [](const auto& l, const auto& r) { return l.first < r.first; });
+  std::size_t nPixels = 0;
+  for (std::size_t i = 0; i < fPixelCharges.size(); i++) {
+    if (nPixels > 0 && fPixelCharges[nPixels - 1].first == fPixelCharges[i].first) {
+      fPixelCharges[nPixels - 1].second += fPixelCharges[i].second;
+    }
+    else {
+      fPixelCharges[nPixels++] = fPixelCharges[i];
+    }
+  }
+  fPixelCharges.resize(nPixels);
+
+  //------------------------------------------------
+  // 4. noise, threshold and zero suppression
+  for (const auto& [key, charge] : fPixelCharges) {
+    G4double q = charge + (fNoise > 0. ? G4RandGauss::shoot(0., fNoise) : 0.);
+    if (q < fThreshold) continue;
+    digits->insert(new PixelDigi(PixelGeometry::KeyLayer(key), PixelGeometry::KeyRow(key), PixelGeometry::KeyCol(key), q));
+  }
+
+  // 5. noise-only pixels anywhere in the detector
+  if (fNoiseHits && fNoise > 0. && fThreshold > 0.) {
+    G4double cut = fThreshold / fNoise;
+    G4double tail = 0.5 * std::erfc(cut / std::sqrt(2.));
+    G4long nNoise = G4Poisson(tail * nLayers * static_cast<G4double>(nX) * nY);
+    for (G4long n = 0; n < nNoise; n++) {
+      G4int layer = static_cast<G4int>(G4UniformRand() * nLayers);
+      G4int ix = static_cast<G4int>(G4UniformRand() * nX);
+      G4int iy = static_cast<G4int>(G4UniformRand() * nY);
+      // pixels with signal already had their noise added
+      if (std::binary_search(fPixelCharges.begin(), fPixelCharges.end(), std::make_pair(PixelGeometry::Key(layer, ix, iy), 0.f),
+                             [](const auto& l, const auto& r) { return l.first < r.first; })) continue;
+      digits->insert(new PixelDigi(layer, ix, iy, fNoise * NormalTail(cut)));
+    }
+  }
+
+  if (verboseLevel > 0) {
+    G4cout << "PixelDigitizer: " << deposits.size() << " deposits, " << nPoints << " charge points, "
+           << nPixels << " pixels with charge, " << digits->entries() << " digits" << G4endl;
+  }
+  StoreDigiCollection(digits);
+}
@@ -0,0 +1,85 @@
+#include "PixelDigitizerMessenger.hh"
+
+#include "PixelDigitizer.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PixelDigitizerMessenger::PixelDigitizerMessenger(PixelDigitizer* digitizer)
+  : fDigitizer(digitizer)
+{
+  fDigiDir = new G4UIdirectory("/digi/");
+  fDigiDir->SetGuidance("pixel digitisation control");
+
+  fEnableCmd = new G4UIcmdWithABool("/digi/enable", this);
+  fEnableCmd->SetGuidance("digitise the pixel deposits and write the pixelDigits tree");
+  fEnableCmd->SetParameterName("enable", true);
+  fEnableCmd->SetDefaultValue(true);
+  fEnableCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fThresholdCmd = new G4UIcmdWithADouble("/digi/threshold", this);
+  fThresholdCmd->SetGuidance("set the pixel threshold in electrons");
+  fThresholdCmd->SetParameterName("threshold", false);
+  fThresholdCmd->SetRange("threshold>=0");
+  fThresholdCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fNoiseCmd = new G4UIcmdWithADouble("/digi/noise", this);
+  fNoiseCmd->SetGuidance("set the Gaussian pixel noise in electrons");
+  fNoiseCmd->SetParameterName("noise", false);
+  fNoiseCmd->SetRange("noise>=0");
+  fNoiseCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fDiffusionCmd = new G4UIcmdWithADoubleAndUnit("/digi/diffusion", this);
+  fDiffusionCmd->SetGuidance("set the diffusion width of charge drifting through the whole sensor");
+  fDiffusionCmd->SetParameterName("diffusion", false);
+  fDiffusionCmd->SetRange("diffusion>=0");
+  fDiffusionCmd->SetUnitCategory("Length");
+  fDiffusionCmd->SetDefaultUnit("um");
+  fDiffusionCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fNoiseHitsCmd = new G4UIcmdWithABool("/digi/noiseHits", this);
+  fNoiseHitsCmd->SetGuidance("add pixels firing on noise alone anywhere in the detector");
+  fNoiseHitsCmd->SetParameterName("noiseHits", true);
+  fNoiseHitsCmd->SetDefaultValue(true);
+  fNoiseHitsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+PixelDigitizerMessenger::~PixelDigitizerMessenger()
+{
+  delete fEnableCmd;
+  delete fThresholdCmd;
+  delete fNoiseCmd;
+  delete fDiffusionCmd;
+  delete fNoiseHitsCmd;
+  delete fDigiDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PixelDigitizerMessenger::SetNewValue(G4UIcommand* command, G4String newValues)
+{
+  if (command == fEnableCmd) fDigitizer->SetEnabled(fEnableCmd->GetNewBoolValue(newValues));
+  else if (command == fThresholdCmd) fDigitizer->SetThreshold(fThresholdCmd->GetNewDoubleValue(newValues));
+  else if (command == fNoiseCmd) fDigitizer->SetNoise(fNoiseCmd->GetNewDoubleValue(newValues));
+  else if (command == fDiffusionCmd) fDigitizer->SetDiffusion(fDiffusionCmd->GetNewDoubleValue(newValues));
+  else if (command == fNoiseHitsCmd) fDigitizer->SetNoiseHits(fNoiseHitsCmd->GetNewBoolValue(newValues));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String PixelDigitizerMessenger::GetCurrentValue(G4UIcommand* command)
+{
+  if (command == fEnableCmd) return fEnableCmd->ConvertToString(fDigitizer->IsEnabled());
+  if (command == fThresholdCmd) return fThresholdCmd->ConvertToString(fDigitizer->GetThreshold());
+  if (command == fNoiseCmd) return fNoiseCmd->ConvertToString(fDigitizer->GetNoise());
+  if (command == fDiffusionCmd) return fDiffusionCmd->ConvertToString(fDigitizer->GetDiffusion(), "um");
+  if (command == fNoiseHitsCmd) return fNoiseHitsCmd->ConvertToString(fDigitizer->GetNoiseHits());
+  return "";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
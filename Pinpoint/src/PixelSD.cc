@@ -10,10 +10,21 @@
 #include "G4SystemOfUnits.hh"
 #include "G4ios.hh"
 #include <map>
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cstdint>
 #include "G4LorentzVector.hh"
 #include "G4RunManager.hh"
 #include "G4Event.hh"
 #include "TrackInformation.hh"
+#include "EventInformation.hh"
+#include "AnalysisManager.hh"
+#include "MuonOverlay.hh"
+#include "PixelGeometry.hh"
+#include "PixelDigitizer.hh"
+#include "G4DigiManager.hh"
+#include "G4NavigationHistory.hh"
 
 
 // std::set<G4int> PixelSD::sPrimaryDescendants;
@@ -73,6 +84,9 @@ static std::unordered_map<PixelKey, PixelID> bestPixels;
 static std::unordered_map<PixelKey, double>  totalCharge;
 
 
+// (pixel, -deposit, trackID) of every track in every pixel, for the truth links
+static std::vector<std::tuple<std::uint64_t, G4double, G4int>> truthContributions;
+
 // Map to accumulate charge in each pixel during an event
 static std::map<PixelID, G4double> pixelChargeMap;
 // Map to track if pixel received energy from muon descendants
@@ -82,6 +96,7 @@ PixelSD::PixelSD(const G4String& name, const G4String& hitsCollectionName)
   : G4VSensitiveDetector(name)
 {
   collectionName.insert(hitsCollectionName);
+  collectionName.insert("ActsHitsCollection");
 }
 
 
@@ -91,6 +106,17 @@ void PixelSD::Initialize(G4HCofThisEvent* hce)
 
   G4int hcID = G4SDManager::GetSDMpointer()->GetCollectionID(collectionName[0]);
   hce->AddHitsCollection(hcID, fHitsCollection);
+
+  fActsHitsCollection = new ActsHitsCollection(SensitiveDetectorName, collectionName[1]);
+  G4int actsHcID = G4SDManager::GetSDMpointer()->GetCollectionID(collectionName[1]);
+  hce->AddHitsCollection(actsHcID, fActsHitsCollection);
+  fSaveActs = AnalysisManager::GetInstance()->GetSaveActs();
+
+  auto digitizer = static_cast<PixelDigitizer*>(G4DigiManager::GetDMpointer()->FindDigitizerModule("PixelDigitizer"));
+  fRecordDeposits = digitizer && digitizer->IsEnabled();
+  fDeposits.clear();
+  fSaveTruthLinks = AnalysisManager::GetInstance()->GetSaveTruthLinks();
+  fTruthLinks.clear();
   
   // Clear the pixel charge map for this event
   pixelChargeMap.clear();
@@ -141,6 +167,35 @@ G4bool PixelSD::ProcessHits(G4Step* step, G4TouchableHistory* /*history*/)
   PixelID pixelId = {layerID, rowID, colID, p4, pdgid, charge, trackID};
   pixelChargeMap[pixelId] += edep;
 
+  // Keep the raw step for the ACTS simhit output
+  if (fSaveActs) {
+    G4StepPoint* postStepPoint = step->GetPostStepPoint();
+    auto actsHit = new ActsHit();
+    actsHit->SetTrackID(trackID);
+    actsHit->SetLayerID(layerID);
+    actsHit->SetX4(G4LorentzVector(preStepPoint->GetPosition(), preStepPoint->GetGlobalTime()));
+    actsHit->SetP4Before(G4LorentzVector(preStepPoint->GetMomentum(), preStepPoint->GetTotalEnergy()));
+    actsHit->SetP4After(G4LorentzVector(postStepPoint->GetMomentum(), postStepPoint->GetTotalEnergy()));
+    actsHit->SetEnergyDeposit(edep);
+    fActsHitsCollection->insert(actsHit);
+  }
+
+  // Keep the step as a segment in the silicon layer frame for the digitisation
+  if (fRecordDeposits) {
+    // depth 0: pixel, 1: pixel row, 2: silicon layer
+    const G4AffineTransform& toLayer = touchable->GetHistory()->GetTransform(touchable->GetHistoryDepth() - 2);
+    G4ThreeVector entry = toLayer.TransformPoint(preStepPoint->GetPosition());
+    G4ThreeVector exit = toLayer.TransformPoint(step->GetPostStepPoint()->GetPosition());
+    fDeposits.layer.push_back(layerID);
+    fDeposits.x0.push_back(entry.x());
+    fDeposits.y0.push_back(entry.y());
+    fDeposits.z0.push_back(entry.z());
+    fDeposits.x1.push_back(exit.x());
+    fDeposits.y1.push_back(exit.y());
+    fDeposits.z1.push_back(exit.z());
+    fDeposits.edep.push_back(edep);
+  }
+
   // Register hit in TrackInformation
   // TrackInformation* trackInfo = dynamic_cast<TrackInformation*>(track->GetUserInformation());
   // if (!trackInfo) {
@@ -162,14 +217,15 @@ G4bool PixelSD::ProcessHits(G4Step* step, G4TouchableHistory* /*history*/)
 
 void PixelSD::EndOfEvent(G4HCofThisEvent* /*hce*/)
 {
-  // Get detector geometry parameters from DetectorConstruction
-  // G4double tungstenThickness = DetectorConstruction::GetTungstenThickness();
-  // G4double siliconThickness = DetectorConstruction::GetSiliconThickness();
-  // G4double detectorSizeX = DetectorConstruction::GetDetectorSizeX();
-  // G4double detectorSizeY = DetectorConstruction::GetDetectorSizeY();
-  // G4double pixelSizeX = DetectorConstruction::GetPixelSizeX();
-  // G4double pixelSizeY = DetectorConstruction::GetPixelSizeY();
-  // G4double layerThickness = DetectorConstruction::GetLayerThickness();
+  // hits only carry channel IDs, positions come from DetectorConstruction::GetPixelGeometry()
+
+  // every (pixel, track) deposit, before the tracks of a pixel are collapsed
+  // into one hit; sorted once the overlay is added
+  if (fSaveTruthLinks) {
+    truthContributions.clear();
+    for (const auto& [pixel, charge] : pixelChargeMap)
+      truthContributions.emplace_back(PixelGeometry::Key(pixel.layerID, pixel.rowID, pixel.colID), -charge, pixel.trackID);
+  }
 
   for (const auto& [pixel, charge] : pixelChargeMap) {
     PixelKey key{pixel.layerID, pixel.rowID, pixel.colID};
@@ -212,22 +268,6 @@ void PixelSD::EndOfEvent(G4HCofThisEvent* /*hce*/)
       newHit->SetEnergyDeposit(totalCharge);
       newHit->SetFromMuon(pixelFromMuonMap[pixelId]);  // Set if any track from muon hit this pixel
       
-      // Calculate pixel center position in global coordinates
-      // X position: pixel index to world coordinates
-      // G4double pixelCenterX = (pixelId.rowID + 0.5) * pixelSizeX - detectorSizeX/2.0;
-      
-      // // Y position: pixel index to world coordinates  
-      // G4double pixelCenterY = (pixelId.colID + 0.5) * pixelSizeY - detectorSizeY/2.0;
-      
-      // // Z position: layer position + silicon layer offset
-      // // Detector starts at z=0, so layer 0 starts at z=0
-      // G4double layerCenterZ = (pixelId.layerID + 0.5) * layerThickness;
-      // // Add offset to silicon layer center within the layer
-      // G4double siliconOffsetZ = tungstenThickness + siliconThickness/2.0;
-      // G4double pixelCenterZ = layerCenterZ - layerThickness/2.0 + siliconOffsetZ;
-      
-      // newHit->SetPos(G4ThreeVector(pixelCenterX, pixelCenterY, pixelCenterZ));
-      
       // Set default values for other fields since we're aggregating
       // newHit->SetTrackID(-1); // Multiple tracks may contribute
       // newHit->SetPDGCode(0);   // Multiple particle types may contribute
@@ -237,6 +277,43 @@ void PixelSD::EndOfEvent(G4HCofThisEvent* /*hce*/)
     }
   }
 
+  // store the hits in the muon library and/or add the muon background, seeded
+  // like the event from its index in the whole sample (see SeedService)
+  const G4Event* event = G4RunManager::GetRunManager()->GetCurrentEvent();
+  G4long eventIndex = 0;
+  if (event) {
+    auto eventInfo = static_cast<const EventInformation*>(event->GetUserInformation());
+    eventIndex = (eventInfo && eventInfo->GetEventIndex() >= 0) ? eventInfo->GetEventIndex() : event->GetEventID();
+  }
+  MuonOverlay* overlay = MuonOverlay::GetInstance();
+  overlay->EndOfEvent(fHitsCollection, eventIndex);
+
+  // truth links of the final hits: the fractions are the shares of the
+  // deposit of every track, overlaid muons included, so that they still sum
+  // to one where the overlay adds charge to a pixel of the signal event
+  if (fSaveTruthLinks) {
+    for (const auto& deposit : overlay->GetDeposits())
+      truthContributions.emplace_back(deposit.pixelKey, -deposit.edep, deposit.trackID);
+    // by pixel, then decreasing deposit
+    std::sort(truthContributions.begin(), truthContributions.end());
+
+    for (std::size_t i = 0; i < fHitsCollection->entries(); i++) {
+      const PixelHit* hit = (*fHitsCollection)[i];
+      std::uint64_t pixelKey = PixelGeometry::Key(hit->GetLayerID(), hit->GetRowID(), hit->GetColID());
+      auto first = std::lower_bound(truthContributions.begin(), truthContributions.end(),
+                                    std::make_tuple(pixelKey, -DBL_MAX, INT_MIN));
+      auto last = first;
+      G4double total = 0.;
+      for (; last != truthContributions.end() && std::get<0>(*last) == pixelKey; ++last) total -= std::get<1>(*last);
+
+      fTruthLinks.offset.push_back(fTruthLinks.trackID.size());
+      for (auto it = first; it != last; ++it) {
+        fTruthLinks.trackID.push_back(std::get<2>(*it));
+        fTruthLinks.fraction.push_back(-std::get<1>(*it) / total);
+      }
+    }
+  }
+
   if (verboseLevel > 1) {
     std::size_t nofHits = fHitsCollection->entries();
     G4cout << G4endl << "-------->Hits Collection: in this event there are " << nofHits
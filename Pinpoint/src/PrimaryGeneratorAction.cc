@@ -3,10 +3,12 @@
 
 #include "generators/GeneratorBase.hh"
 #include "generators/GENIEGenerator.hh"
+#include "generators/GFaserGenerator.hh"
 #include "generators/HepMCGenerator.hh"
 #include "generators/GPSGenerator.hh"
 
 #include "EventInformation.hh"
+#include "SeedService.hh"
 
 #include "G4Event.hh"
 #include "G4Exception.hh"
@@ -17,6 +19,9 @@ PrimaryGeneratorAction::PrimaryGeneratorAction()
   // create a messenger for this class
   fGenMessenger = new PrimaryGeneratorMessenger(this);
 
+  // create the seeding service now so that /random/masterSeed is available in macros
+  SeedService::GetInstance();
+
   // start with default generator
   fGenerator = new GPSGenerator();
   fInitialized = false;
@@ -35,6 +40,8 @@ void PrimaryGeneratorAction::SetGenerator(G4String name)
 
   if( name == "genie" )
     fGenerator = new GENIEGenerator();
+  else if( name == "gfaser" )
+    fGenerator = new GFaserGenerator();
   else if( name == "hepmc" )
     fGenerator = new HepMCGenerator();
   else if ( name == "gun" )
@@ -48,6 +55,11 @@ void PrimaryGeneratorAction::SetGenerator(G4String name)
   }
 }
 
+G4String PrimaryGeneratorAction::GetGeneratorName() const
+{
+  return fGenerator->GetGeneratorName();
+}
+
 
 void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
 {
@@ -58,8 +70,12 @@ void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
     fInitialized = true;
   }
 
+  // the random sequence of every event only depends on the master seed and the event index
+  G4long eventIndex = fGenerator->GetNextEventIndex(anEvent);
+  SeedService::GetInstance()->SeedEvent(eventIndex);
+
   G4cout << G4endl;
-  G4cout << "===oooOOOooo=== Event Generator (# " << anEvent->GetEventID();
+  G4cout << "===oooOOOooo=== Event Generator (# " << anEvent->GetEventID() << ", seeded as event " << eventIndex;
 
   // reset event metadata
   fGenerator->ResetEventMetadata();
@@ -68,6 +84,8 @@ void PrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
   fGenerator->GeneratePrimaries(anEvent);
 
   // save vertex metadata information into the event
-  anEvent->SetUserInformation(new EventInformation(fGenerator->GetEventMetadata()));
+  auto eventInfo = new EventInformation(fGenerator->GetEventMetadata());
+  eventInfo->SetEventIndex(eventIndex);
+  anEvent->SetUserInformation(eventInfo);
 
 }
@@ -3,7 +3,11 @@
 #include "PrimaryGeneratorAction.hh"
 #include "G4UIdirectory.hh"
 #include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
 #include "G4UIcmdWithAString.hh"
+#include "generators/ParticleDefinitionCache.hh"
+
+#include <sstream>
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -16,10 +20,23 @@ PrimaryGeneratorMessenger::PrimaryGeneratorMessenger(PrimaryGeneratorAction* act
   fGeneratorOption = new G4UIcmdWithAString("/gen/select", this);
   fGeneratorOption->SetGuidance("select generator option");
   fGeneratorOption->SetParameterName("generator",false);
-  fGeneratorOption->SetCandidates("gun genie hepmc");
+  fGeneratorOption->SetCandidates("gun genie gfaser hepmc");
   fGeneratorOption->SetDefaultValue("gun");
   fGeneratorOption->AvailableForStates(G4State_PreInit, G4State_Init, G4State_Idle);
 
+  fPseudoParticleCmd = new G4UIcommand("/gen/pseudoParticles", this);
+  fPseudoParticleCmd->SetGuidance("what to do with GENIE pseudo-particles (PDG 2000000001-2000000202) in the input");
+  fPseudoParticleCmd->SetGuidance("skip: not passed to Geant4 (default); geantino or chargedGeantino: tracked as such");
+  fPseudoParticleCmd->SetGuidance("pdg: a single pseudo-particle, 0 (default) for all of them");
+  G4UIparameter* policyParam = new G4UIparameter("policy", 's', false);
+  policyParam->SetParameterCandidates("skip geantino chargedGeantino");
+  fPseudoParticleCmd->SetParameter(policyParam);
+  G4UIparameter* pdgParam = new G4UIparameter("pdg", 'i', true);
+  pdgParam->SetDefaultValue(0);
+  pdgParam->SetParameterRange("pdg==0 || (pdg>=2000000001 && pdg<=2000000202)");
+  fPseudoParticleCmd->SetParameter(pdgParam);
+  fPseudoParticleCmd->AvailableForStates(G4State_PreInit, G4State_Init, G4State_Idle);
+
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -27,6 +44,7 @@ PrimaryGeneratorMessenger::PrimaryGeneratorMessenger(PrimaryGeneratorAction* act
 PrimaryGeneratorMessenger::~PrimaryGeneratorMessenger()
 {
   delete fGeneratorOption;
+  delete fPseudoParticleCmd;
   delete fGeneratorDir;
 }
 
@@ -36,6 +54,29 @@ void PrimaryGeneratorMessenger::SetNewValue(G4UIcommand* command, G4String newVa
 {
   if (command == fGeneratorOption) 
     fPrimGenAction->SetGenerator(newValues);
+  else if (command == fPseudoParticleCmd) {
+    G4String policyName;
+    G4int pdg = 0;
+    std::istringstream is(newValues);
+    is >> policyName >> pdg;
+    auto cache = ParticleDefinitionCache::GetInstance();
+    auto policy = ParticleDefinitionCache::PolicyFromString(policyName);
+    if (pdg == 0) cache->SetPseudoParticlePolicy(policy);
+    else cache->SetPseudoParticlePolicy(pdg, policy);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String PrimaryGeneratorMessenger::GetCurrentValue(G4UIcommand* command)
+{
+  if (command == fGeneratorOption) return fPrimGenAction->GetGeneratorName();
+  // the policy of all pseudo-particles, not the overrides of single PDG codes
+  if (command == fPseudoParticleCmd) {
+    auto cache = ParticleDefinitionCache::GetInstance();
+    return ParticleDefinitionCache::PolicyToString(cache->GetPseudoParticlePolicy()) + " 0";
+  }
+  return "";
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -1,6 +1,8 @@
 #include "RunAction.hh"
 
 #include "AnalysisManager.hh"
+#include "MuonOverlay.hh"
+#include "generators/ParticleDefinitionCache.hh"
 
 RunAction::RunAction() :
   G4UserRunAction() 
@@ -8,16 +10,23 @@ RunAction::RunAction() :
   //* This will ensure that the AnalysisManager singleton is created at the start of the run action
   //* We need to do this so that we can pass macro commands to it before the run starts
   AnalysisManager* analysis = AnalysisManager::GetInstance();
+  MuonOverlay::GetInstance();
 }
 
 void RunAction::BeginOfRunAction(const G4Run*) {
   AnalysisManager* analysis = AnalysisManager::GetInstance();
   analysis->BeginOfRun();
+  MuonOverlay::GetInstance()->BeginOfRun();
 }
 
 void RunAction::EndOfRunAction(const G4Run* run) {
   AnalysisManager* analysis = AnalysisManager::GetInstance();
   analysis->EndOfRun();
+  MuonOverlay::GetInstance()->EndOfRun();
+
+  // summary of the generator particles that could not be tracked
+  ParticleDefinitionCache::GetInstance()->PrintSkipped();
+  ParticleDefinitionCache::GetInstance()->ResetSkipped();
 
   // retrieve the number of events produced in the run
   G4int nofEvents = run->GetNumberOfEvent();
@@ -0,0 +1,56 @@
+#include "SeedService.hh"
+#include "SeedServiceMessenger.hh"
+
+#include "Randomize.hh"
+
+SeedService* SeedService::fInstance = nullptr;
+
+SeedService* SeedService::GetInstance()
+{
+  if (!fInstance) fInstance = new SeedService();
+  return fInstance;
+}
+
+SeedService::SeedService()
+  : fMasterSeed(1)
+{
+  fMessenger = new SeedServiceMessenger(this);
+}
+
+SeedService::~SeedService()
+{
+  delete fMessenger;
+}
+
+void SeedService::SetMasterSeed(G4long seed)
+{
+  fMasterSeed = seed;
+  G4cout << "SeedService: master seed set to " << fMasterSeed << G4endl;
+}
+
+std::uint64_t SeedService::Mix(std::uint64_t a, std::uint64_t b)
+{
+  std::uint64_t z = a * 0x9e3779b97f4a7c15ULL + b;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+std::uint64_t SeedService::StreamSeed(G4int stream, G4long streamSeed, G4long key) const
+{
+  std::uint64_t seed = Mix(static_cast<std::uint64_t>(fMasterSeed), static_cast<std::uint64_t>(stream));
+  seed = Mix(seed, static_cast<std::uint64_t>(streamSeed));
+  return Mix(seed, static_cast<std::uint64_t>(key));
+}
+
+void SeedService::SeedEvent(G4long eventIndex) const
+{
+  std::uint64_t seed = StreamSeed(kEventStream, 0, eventIndex);
+
+  // two non-zero 31-bit seeds, the list is zero terminated
+  long seeds[3];
+  seeds[0] = static_cast<long>(seed & 0x7fffffff) | 1;
+  seeds[1] = static_cast<long>((seed >> 32) & 0x7fffffff) | 1;
+  seeds[2] = 0;
+  G4Random::setTheSeeds(seeds);
+}
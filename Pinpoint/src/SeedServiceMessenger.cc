@@ -0,0 +1,59 @@
+#include "SeedServiceMessenger.hh"
+
+#include "SeedService.hh"
+#include "G4UIcmdWithAString.hh"
+
+#include <stdexcept>
+#include <string>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SeedServiceMessenger::SeedServiceMessenger(SeedService* service)
+  : fSeedService(service)
+{
+  // the /random/ directory is created by the Geant4 run manager
+  // a string command: integer commands are 32 bit, the seed is a G4long
+  fMasterSeedCmd = new G4UIcmdWithAString("/random/masterSeed", this);
+  fMasterSeedCmd->SetGuidance("set the master seed of the run");
+  fMasterSeedCmd->SetGuidance("the engine is reseeded before every event from hash(master seed, event index)");
+  fMasterSeedCmd->SetParameterName("seed", false);
+  fMasterSeedCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+SeedServiceMessenger::~SeedServiceMessenger()
+{
+  delete fMasterSeedCmd;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void SeedServiceMessenger::SetNewValue(G4UIcommand* command, G4String newValues)
+{
+  if (command == fMasterSeedCmd) {
+    G4long seed = 0;
+    std::size_t end = 0;
+    try {
+      seed = std::stoll(newValues, &end);
+    } catch (const std::exception&) {
+      end = 0;
+    }
+    if (end == 0 || end != newValues.size()) {
+      G4String err = "/random/masterSeed expects an integer, got " + newValues;
+      G4Exception("SeedServiceMessenger", "BadSeed", FatalErrorInArgument, err.c_str());
+      return;
+    }
+    fSeedService->SetMasterSeed(seed);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String SeedServiceMessenger::GetCurrentValue(G4UIcommand* command)
+{
+  if (command == fMasterSeedCmd) return std::to_string(fSeedService->GetMasterSeed());
+  return "";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
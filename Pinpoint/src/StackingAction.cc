@@ -42,6 +42,10 @@ G4ClassificationOfNewTrack StackingAction::ClassifyNewTrack (const G4Track* aTra
   // add track with its ancestor!!!
   AnalysisManager::GetInstance()->SetTrackPrimaryAncestor(trackID,ancestorID);
 
+  // keep the track lineage for the ACTS particle output
+  if (AnalysisManager::GetInstance()->GetSaveActs())
+    AnalysisManager::GetInstance()->RegisterActsParticle(aTrack);
+
   // Do not affect track classification. Just return what would have
   // been returned by the base class
   return G4UserStackingAction::ClassifyNewTrack(aTrack);
@@ -1,10 +1,12 @@
 #include "SteppingAction.hh"
 #include "RunAction.hh"
+#include "AnalysisManager.hh"
 
 #include <G4Step.hh>
 #include <G4Electron.hh>
 #include <G4TrackStatus.hh>
 #include <G4SystemOfUnits.hh>
+#include <G4Material.hh>
 
 #include <TMath.h>
 
@@ -24,6 +26,16 @@ void SteppingAction::UserSteppingAction(const G4Step* aStep) {
   G4VPhysicalVolume* volume = aStep->GetPostStepPoint()->GetTouchable()->GetVolume();
 
   // if( volume->GetName() == "expHall_P" ) aTrack->SetTrackStatus(G4TrackStatus::fStopAndKill);
+
+  // material budget traversed by each particle, for the ACTS particle output
+  AnalysisManager* analysis = AnalysisManager::GetInstance();
+  if (analysis->GetSaveActs()) {
+    const G4Material* material = aStep->GetPreStepPoint()->GetMaterial();
+    G4double stepLength = aStep->GetStepLength();
+    analysis->AddActsMaterial(aTrack->GetTrackID(),
+                              stepLength / material->GetRadlen(),
+                              stepLength / material->GetNuclearInterLength());
+  }
 }
 
 void SteppingAction::TrackLiveDebugging(const G4Step* step){
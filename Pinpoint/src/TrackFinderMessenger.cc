@@ -0,0 +1,142 @@
+#include "TrackFinderMessenger.hh"
+
+#include <sstream>
+
+#include "AnalysisManager.hh"
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADouble.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4SystemOfUnits.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+TrackFinderMessenger::TrackFinderMessenger(AnalysisManager* manager)
+  : fAnalysisManager(manager)
+{
+  fRecoDir = new G4UIdirectory("/reco/");
+  fRecoDir->SetGuidance("inline reconstruction control");
+
+  fFindTracksCmd = new G4UIcmdWithABool("/reco/findTracks", this);
+  fFindTracksCmd->SetGuidance("find straight tracks in the pixel hits of every event and write them (Hits/tracks)");
+  fFindTracksCmd->SetParameterName("findTracks", true);
+  fFindTracksCmd->SetDefaultValue(true);
+  fFindTracksCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fMinHitsCmd = new G4UIcmdWithAnInteger("/reco/minHits", this);
+  fMinHitsCmd->SetGuidance("minimum number of hits of a track");
+  fMinHitsCmd->SetParameterName("minHits", false);
+  fMinHitsCmd->SetRange("minHits>=3");
+  fMinHitsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fMaxSlopeCmd = new G4UIcmdWithADouble("/reco/maxSlope", this);
+  fMaxSlopeCmd->SetGuidance("maximum slope dx/dz and dy/dz of a track");
+  fMaxSlopeCmd->SetParameterName("maxSlope", false);
+  fMaxSlopeCmd->SetRange("maxSlope>0");
+  fMaxSlopeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fToleranceCmd = new G4UIcmdWithADoubleAndUnit("/reco/tolerance", this);
+  fToleranceCmd->SetGuidance("maximum distance between the predicted track position and a hit in a layer");
+  fToleranceCmd->SetParameterName("tolerance", false);
+  fToleranceCmd->SetRange("tolerance>0");
+  fToleranceCmd->SetUnitCategory("Length");
+  fToleranceCmd->SetDefaultUnit("um");
+  fToleranceCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fMaxMissingCmd = new G4UIcmdWithAnInteger("/reco/maxMissing", this);
+  fMaxMissingCmd->SetGuidance("stop following a track after this many consecutive layers without a hit");
+  fMaxMissingCmd->SetParameterName("maxMissing", false);
+  fMaxMissingCmd->SetRange("maxMissing>=0");
+  fMaxMissingCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fMaxChi2Cmd = new G4UIcmdWithADouble("/reco/maxChi2", this);
+  fMaxChi2Cmd->SetGuidance("maximum chi2 per degree of freedom of a track");
+  fMaxChi2Cmd->SetParameterName("maxChi2", false);
+  fMaxChi2Cmd->SetRange("maxChi2>0");
+  fMaxChi2Cmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fIsolationCmd = new G4UIcommand("/reco/isolation", this);
+  fIsolationCmd->SetGuidance("seeds only use hits with at most maxHits hits (themselves included) within +-pixels rows and columns");
+  G4UIparameter* pixelsParam = new G4UIparameter("pixels", 'i', false);
+  pixelsParam->SetParameterRange("pixels>=0");
+  fIsolationCmd->SetParameter(pixelsParam);
+  G4UIparameter* maxHitsParam = new G4UIparameter("maxHits", 'i', false);
+  maxHitsParam->SetParameterRange("maxHits>=1");
+  fIsolationCmd->SetParameter(maxHitsParam);
+  fIsolationCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fMaxTracksCmd = new G4UIcmdWithAnInteger("/reco/maxTracks", this);
+  fMaxTracksCmd->SetGuidance("maximum number of tracks per event");
+  fMaxTracksCmd->SetParameterName("maxTracks", false);
+  fMaxTracksCmd->SetRange("maxTracks>0");
+  fMaxTracksCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fMaxSeedsCmd = new G4UIcmdWithAnInteger("/reco/maxSeeds", this);
+  fMaxSeedsCmd->SetGuidance("maximum number of seeds followed per event");
+  fMaxSeedsCmd->SetParameterName("maxSeeds", false);
+  fMaxSeedsCmd->SetRange("maxSeeds>0");
+  fMaxSeedsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+TrackFinderMessenger::~TrackFinderMessenger()
+{
+  delete fFindTracksCmd;
+  delete fMinHitsCmd;
+  delete fMaxSlopeCmd;
+  delete fToleranceCmd;
+  delete fMaxMissingCmd;
+  delete fMaxChi2Cmd;
+  delete fIsolationCmd;
+  delete fMaxTracksCmd;
+  delete fMaxSeedsCmd;
+  delete fRecoDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void TrackFinderMessenger::SetNewValue(G4UIcommand* command, G4String newValues)
+{
+  TrackFinder& finder = fAnalysisManager->GetTrackFinder();
+  if (command == fFindTracksCmd) fAnalysisManager->findTracks(fFindTracksCmd->GetNewBoolValue(newValues));
+  else if (command == fMinHitsCmd) finder.SetMinHits(fMinHitsCmd->GetNewIntValue(newValues));
+  else if (command == fMaxSlopeCmd) finder.SetMaxSlope(fMaxSlopeCmd->GetNewDoubleValue(newValues));
+  else if (command == fToleranceCmd) finder.SetTolerance(fToleranceCmd->GetNewDoubleValue(newValues) / mm);
+  else if (command == fMaxMissingCmd) finder.SetMaxMissing(fMaxMissingCmd->GetNewIntValue(newValues));
+  else if (command == fMaxChi2Cmd) finder.SetMaxChi2(fMaxChi2Cmd->GetNewDoubleValue(newValues));
+  else if (command == fIsolationCmd) {
+    G4int pixels, maxHits;
+    std::istringstream is(newValues);
+    is >> pixels >> maxHits;
+    finder.SetIsolation(pixels, maxHits);
+  }
+  else if (command == fMaxTracksCmd) finder.SetMaxTracks(fMaxTracksCmd->GetNewIntValue(newValues));
+  else if (command == fMaxSeedsCmd) finder.SetMaxSeeds(fMaxSeedsCmd->GetNewIntValue(newValues));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String TrackFinderMessenger::GetCurrentValue(G4UIcommand* command)
+{
+  const TrackFinder& finder = fAnalysisManager->GetTrackFinder();
+  if (command == fFindTracksCmd) return fFindTracksCmd->ConvertToString(fAnalysisManager->GetFindTracks());
+  if (command == fMinHitsCmd) return fMinHitsCmd->ConvertToString(finder.GetMinHits());
+  if (command == fMaxSlopeCmd) return fMaxSlopeCmd->ConvertToString(finder.GetMaxSlope());
+  if (command == fToleranceCmd) return fToleranceCmd->ConvertToString(finder.GetTolerance() * mm, "um");
+  if (command == fMaxMissingCmd) return fMaxMissingCmd->ConvertToString(finder.GetMaxMissing());
+  if (command == fMaxChi2Cmd) return fMaxChi2Cmd->ConvertToString(finder.GetMaxChi2());
+  if (command == fIsolationCmd) {
+    std::ostringstream os;
+    os << finder.GetIsolation() << " " << finder.GetMaxNeighbours();
+    return os.str();
+  }
+  if (command == fMaxTracksCmd) return fMaxTracksCmd->ConvertToString(finder.GetMaxTracks());
+  if (command == fMaxSeedsCmd) return fMaxSeedsCmd->ConvertToString(finder.GetMaxSeeds());
+  return "";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -13,6 +13,9 @@ void TrackingAction::PreUserTrackingAction(const G4Track* aTrack)
 
 void TrackingAction::PostUserTrackingAction(const G4Track* aTrack)
 {
+  if (AnalysisManager::GetInstance()->GetSaveActs())
+    AnalysisManager::GetInstance()->FinalizeActsParticle(aTrack);
+
   if (aTrack->GetParentID()==0) 
   {
     AnalysisManager::GetInstance()->AddOnePrimaryTrack();
@@ -0,0 +1,88 @@
+#include "generators/EntrySelectionCommands.hh"
+#include "generators/GeneratorBase.hh"
+
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EntrySelectionCommands::EntrySelectionCommands(G4UImessenger* messenger, const G4String& directory, const G4String& entries)
+{
+  fRangeCmd = new G4UIcommand((directory + "range").c_str(), messenger);
+  fRangeCmd->SetGuidance(("set the range of " + entries + " to read: first entry and number of entries (-1 for all)").c_str());
+  G4UIparameter* startParam = new G4UIparameter("start", 'i', false);
+  startParam->SetParameterRange("start>=0");
+  fRangeCmd->SetParameter(startParam);
+  G4UIparameter* countParam = new G4UIparameter("count", 'i', true);
+  countParam->SetDefaultValue(-1);
+  fRangeCmd->SetParameter(countParam);
+  fRangeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fShardCmd = new G4UIcommand((directory + "shard").c_str(), messenger);
+  fShardCmd->SetGuidance(("read only shard i of N of the selected " + entries).c_str());
+  fShardCmd->SetGuidance("mode 'contiguous' takes the i-th block of entries, 'strided' takes every N-th entry");
+  G4UIparameter* shardParam = new G4UIparameter("i", 'i', false);
+  shardParam->SetParameterRange("i>=0");
+  fShardCmd->SetParameter(shardParam);
+  G4UIparameter* nShardsParam = new G4UIparameter("N", 'i', false);
+  nShardsParam->SetParameterRange("N>0");
+  fShardCmd->SetParameter(nShardsParam);
+  G4UIparameter* modeParam = new G4UIparameter("mode", 's', true);
+  modeParam->SetParameterCandidates("contiguous strided");
+  modeParam->SetDefaultValue("contiguous");
+  fShardCmd->SetParameter(modeParam);
+  fShardCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EntrySelectionCommands::~EntrySelectionCommands()
+{
+  delete fRangeCmd;
+  delete fShardCmd;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EntrySelectionCommands::Apply(G4UIcommand* command, const G4String& newValues, GeneratorBase* generator) const
+{
+  if (command == fRangeCmd) {
+    G4int start, count;
+    std::istringstream is(newValues);
+    is >> start >> count;
+    generator->SetEntryRange(start, count);
+    return true;
+  }
+  if (command == fShardCmd) {
+    G4int index, nShards;
+    G4String mode;
+    std::istringstream is(newValues);
+    is >> index >> nShards >> mode;
+    generator->SetShard(index, nShards, mode == "strided");
+    return true;
+  }
+  return false;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String EntrySelectionCommands::GetCurrentValue(G4UIcommand* command, const GeneratorBase* generator) const
+{
+  std::ostringstream os;
+  if (command == fRangeCmd) {
+    G4int start, count;
+    generator->GetEntryRange(start, count);
+    os << start << " " << count;
+  }
+  else if (command == fShardCmd) {
+    G4int index, nShards;
+    G4bool strided;
+    generator->GetShard(index, nShards, strided);
+    os << index << " " << nShards << " " << (strided ? "strided" : "contiguous");
+  }
+  return os.str();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -2,27 +2,22 @@
 #include "generators/GENIEGenerator.hh"
 #include "generators/GENIEGeneratorMessenger.hh"
 #include "generators/GeneratorVertexMetadata.hh"
+#include "generators/ParticleDefinitionCache.hh"
 #include "DetectorConstruction.hh"
 
 #include "G4PrimaryVertex.hh"
 #include "G4PrimaryParticle.hh"
-#include "G4ParticleTable.hh"
-#include "G4IonTable.hh"
 #include "G4SystemOfUnits.hh"
 #include "G4Exception.hh"
 #include "G4LorentzVector.hh"
 #include "G4RunManager.hh"
 #include "G4VPhysicalVolume.hh"
-#include "G4LogicalVolume.hh"
-#include "G4VSolid.hh"
-#include "G4Box.hh"
-#include "G4VisExtent.hh"
 #include "G4ThreeVector.hh"
-#include "Randomize.hh"
 
 #include "TMath.h"
 #include "TFile.h"
 #include "TTree.h"
+#include "TEnv.h"
 
 GENIEGenerator::GENIEGenerator()
 {
@@ -32,11 +27,29 @@ GENIEGenerator::GENIEGenerator()
   fGSTFile = nullptr;
   fGSTTree = nullptr;
   fRandomVtx = false;
+  fVtxWeighting = "mass";
+  fVtxSeed = 0;
+  fVertexSampler = nullptr;
   fEventCounter = 0;
+  fEvtStartIdx = 0;
+  fEvtCount = -1;
+  fShardIdx = 0;
+  fNShards = 1;
+  fShardStrided = false;
+
+  fCacheSize = 30;
+  fCacheLearnEntries = 10;
+  fPrefetch = false;
+  fBytesRead = 0;
 }
 
 GENIEGenerator::~GENIEGenerator()
 {
+  if (fGSTFile) {
+    G4cout << "GENIEGenerator: read " << fGSTFile->GetBytesRead()/1024 << " kB in " 
+           << fGSTFile->GetReadCalls() << " read calls for " << fEventCounter << " events" << G4endl;
+  }
+  delete fVertexSampler;
   delete fGSTTree;
   if(fGSTFile) fGSTFile->Close();
   delete fMessenger;
@@ -44,6 +57,8 @@ GENIEGenerator::~GENIEGenerator()
 
 void GENIEGenerator::LoadData()
 {
+  // asynchronous prefetching must be configured before the file is opened
+  if (fPrefetch) gEnv->SetValue("TFile.AsyncPrefetching", 1);
 
   fGSTFile = new TFile(fGSTFilename, "read");
   if (!fGSTFile->IsOpen()) {
@@ -59,87 +74,84 @@ void GENIEGenerator::LoadData()
 
   fNEntries = fGSTTree->GetEntries();
   G4cout << "Input GST tree has " << fNEntries << ((fNEntries==1)? " entry." : " entries.") << G4endl;
+  fEntries = EntrySelection::Resolve(fNEntries, fEvtStartIdx, fEvtCount, fShardIdx, fNShards, fShardStrided);
+  G4cout << "GENIEGenerator: shard " << fShardIdx << "/" << fNShards << (fShardStrided ? " (strided)" : "") 
+         << " reads entries [" << fEntries.first << ", " << fEntries.end << ") with stride " << fEntries.stride << G4endl;
+
+  // only read the branches we actually use
+  // everything else in the gst tree is switched off
+  fGSTTree->SetBranchStatus("*", 0);
+  auto setBranch = [this](const char* name, void* address) {
+    fGSTTree->SetBranchStatus(name, 1);
+    fGSTTree->SetBranchAddress(name, address);
+  };
 
-  fGSTTree->SetBranchAddress("qel",&m_qel); // is QEL?   
-  fGSTTree->SetBranchAddress("mec",&m_mec); // is MEC?
-  fGSTTree->SetBranchAddress("res",&m_res); // is RES?
-  fGSTTree->SetBranchAddress("dis",&m_dis); // is DIS?
-  fGSTTree->SetBranchAddress("coh",&m_coh); // is Coherent?
-  fGSTTree->SetBranchAddress("dfr",&m_dfr); // id Diffractive?
-  fGSTTree->SetBranchAddress("imd",&m_imd); // is IMD?
-  fGSTTree->SetBranchAddress("imdanh",&m_imdanh); // is IMD annihilation?
-  fGSTTree->SetBranchAddress("singlek",&m_singlek); // is single Kaon?
-  fGSTTree->SetBranchAddress("nuel",&m_nuel);  // is ve elastic?
-  fGSTTree->SetBranchAddress("em",&m_em); // is EM process?
-  fGSTTree->SetBranchAddress("cc",&m_cc); // is Weak CC?
-  fGSTTree->SetBranchAddress("nc",&m_nc); // is Weak NC?
-  fGSTTree->SetBranchAddress("charm",&m_charm); // produces charm?
-  fGSTTree->SetBranchAddress("amnugamma",&m_amnugamma); // is anomaly mediated nu gamma?
-
-  fGSTTree->SetBranchAddress("neu",&m_neuPDG); //neutrino PDG
-  fGSTTree->SetBranchAddress("Ev",&m_Ev); // neutrino energy (GeV)
-  fGSTTree->SetBranchAddress("pxv",&m_pxv); // neutrino px (GeV)
-  fGSTTree->SetBranchAddress("pyv",&m_pyv); // neutrino py (Gev)
-  fGSTTree->SetBranchAddress("pzv",&m_pzv); // neutrino pz (GeV)
+  setBranch("qel",&m_qel); // is QEL?   
+  setBranch("mec",&m_mec); // is MEC?
+  setBranch("res",&m_res); // is RES?
+  setBranch("dis",&m_dis); // is DIS?
+  setBranch("coh",&m_coh); // is Coherent?
+  setBranch("dfr",&m_dfr); // id Diffractive?
+  setBranch("imd",&m_imd); // is IMD?
+  setBranch("imdanh",&m_imdanh); // is IMD annihilation?
+  setBranch("singlek",&m_singlek); // is single Kaon?
+  setBranch("nuel",&m_nuel);  // is ve elastic?
+  setBranch("em",&m_em); // is EM process?
+  setBranch("cc",&m_cc); // is Weak CC?
+  setBranch("nc",&m_nc); // is Weak NC?
+  setBranch("charm",&m_charm); // produces charm?
+  setBranch("amnugamma",&m_amnugamma); // is anomaly mediated nu gamma?
+
+  setBranch("neu",&m_neuPDG); //neutrino PDG
+  setBranch("Ev",&m_Ev); // neutrino energy (GeV)
+  setBranch("pxv",&m_pxv); // neutrino px (GeV)
+  setBranch("pyv",&m_pyv); // neutrino py (Gev)
+  setBranch("pzv",&m_pzv); // neutrino pz (GeV)
  
-  fGSTTree->SetBranchAddress("fspl",&m_fslPDG); // primary letpton PDG
-  fGSTTree->SetBranchAddress("El",&m_El); // primary lepton energy (GeV)
-  fGSTTree->SetBranchAddress("pxl",&m_pxl); // primary lepton px (GeV)
-  fGSTTree->SetBranchAddress("pyl",&m_pyl); // primary lepton py (Gev)
-  fGSTTree->SetBranchAddress("pzl",&m_pzl); // primary lepton pz (GeV)
+  setBranch("fspl",&m_fslPDG); // primary letpton PDG
+  setBranch("El",&m_El); // primary lepton energy (GeV)
+  setBranch("pxl",&m_pxl); // primary lepton px (GeV)
+  setBranch("pyl",&m_pyl); // primary lepton py (Gev)
+  setBranch("pzl",&m_pzl); // primary lepton pz (GeV)
   
-  fGSTTree->SetBranchAddress("nf",&m_nf); // number of final state hadrons
-  fGSTTree->SetBranchAddress("pdgf",&m_pdgf); // hadrons PDG
-  fGSTTree->SetBranchAddress("Ef",&m_Ef); // hadrons energy (GeV)
-  fGSTTree->SetBranchAddress("pxf",&m_pxf); // hadrons px (GeV)
-  fGSTTree->SetBranchAddress("pyf",&m_pyf); // hadrons py (Gev)
-  fGSTTree->SetBranchAddress("pzf",&m_pzf); // hadrons pz (GeV)
+  setBranch("nf",&m_nf); // number of final state hadrons
+  setBranch("pdgf",&m_pdgf); // hadrons PDG
+  setBranch("Ef",&m_Ef); // hadrons energy (GeV)
+  setBranch("pxf",&m_pxf); // hadrons px (GeV)
+  setBranch("pyf",&m_pyf); // hadrons py (Gev)
+  setBranch("pzf",&m_pzf); // hadrons pz (GeV)
   
-  fGSTTree->SetBranchAddress("W",&m_W); // invariant hadronic mass (GeV)
-  fGSTTree->SetBranchAddress("Q2",&m_Q2); // momentum transfer (GeV^2)
-  fGSTTree->SetBranchAddress("x",&m_x); // Bjorken x
-  fGSTTree->SetBranchAddress("y",&m_y); // inelasticity
+  setBranch("W",&m_W); // invariant hadronic mass (GeV)
+  setBranch("Q2",&m_Q2); // momentum transfer (GeV^2)
+  setBranch("x",&m_x); // Bjorken x
+  setBranch("y",&m_y); // inelasticity
 
-  fGSTTree->SetBranchAddress("wght",&m_wght); // event weigth
+  setBranch("wght",&m_wght); // event weigth
   
-  fGSTTree->SetBranchAddress("tgt",&m_tgt); // nuclear target pdg
-  fGSTTree->SetBranchAddress("Z",&m_Z); // nuclear target Z
-  fGSTTree->SetBranchAddress("A",&m_A); // nuclear target A
-  fGSTTree->SetBranchAddress("hitnuc",&m_hitnuc); // hit nucleon pfg
+  setBranch("tgt",&m_tgt); // nuclear target pdg
+  setBranch("Z",&m_Z); // nuclear target Z
+  setBranch("A",&m_A); // nuclear target A
+  setBranch("hitnuc",&m_hitnuc); // hit nucleon pfg
+
+  // read the input in large clusters through a TTreeCache
+  // the cache learns the active branches over the first few entries
+  if (fCacheSize > 0) {
+    fGSTTree->SetCacheSize(static_cast<Long64_t>(fCacheSize) * 1024 * 1024);
+    fGSTTree->SetCacheLearnEntries(fCacheLearnEntries);
+    fGSTTree->SetCacheEntryRange(fEntries.first, fEntries.end);
+    G4cout << "GENIEGenerator: TTreeCache of " << fCacheSize << " MB, learning over " 
+           << fCacheLearnEntries << " entries" << (fPrefetch ? ", async prefetch enabled" : "") << G4endl;
+  }
 
-}
+  fBytesRead = fGSTFile->GetBytesRead();
 
-G4bool GENIEGenerator::FindParticleDefinition(G4int const pdg, G4ParticleDefinition* &particleDefinition) const
-{
-  // unknown pgd codes in GENIE --> skip it!
-  // ref: https://internal.dunescience.org/doxygen/ConvertMCTruthToG4_8cxx_source.html
-  // This has been a known issue with GENIE
-  const int genieLo = 2000000001;
-  const int genieHi = 2000000202;
-  if ( pdg >= genieLo && pdg <= genieHi) {
-    G4cout<< "This unknown PDG code [" << pdg << "] was present in the GENIE input, "
-             << "but will not be processed by Geant4."
-             << G4endl;
-    return false; // return bad
-  }
-  
-  if ( pdg == 0) {
-    particleDefinition = G4ParticleTable::GetParticleTable()->FindParticle("opticalphoton");
-  } else {
-    particleDefinition = G4ParticleTable::GetParticleTable()->FindParticle(pdg);
+  // vertices are sampled in the target (absorber) volumes of the detector
+  if (fRandomVtx) {
+    auto detector = (DetectorConstruction*) (G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+    VertexSampler::Weighting weighting = (fVtxWeighting == "volume") ? VertexSampler::Weighting::Volume 
+                                                                    : VertexSampler::Weighting::Mass;
+    fVertexSampler = new VertexSampler(detector->GetTargetPhysVols(), weighting, fVtxSeed);
   }
-  
-  if ( pdg > 1000000000) { // If the particle is a nucleus
-    // If the particle table doesn't have a definition yet, ask the ion
-    // table for one. This will create a new ion definition as needed.
-    if (!particleDefinition) {
-      int Z = (pdg % 10000000) / 10000; // atomic number
-      int A = (pdg % 10000) / 10;       // mass number
-      particleDefinition = G4ParticleTable::GetParticleTable()->GetIonTable()->GetIon(Z, A, 0.);
-    }
-  }
-
-  return true; //return good
 }
 
 void GENIEGenerator::GeneratePrimaries(G4Event* anEvent)
@@ -148,19 +160,30 @@ void GENIEGenerator::GeneratePrimaries(G4Event* anEvent)
   // complete line from PrimaryGeneratorAction...
   G4cout << ") : GENIE Generator ===oooOOOooo===" << G4endl;
   
-  G4cout << "oooOOOooo Event # " << fEventCounter << " oooOOOooo" << G4endl;
-  G4cout << "GeneratePrimaries from file " << fGSTFilename << ", evtID starts from "<< fEvtStartIdx << ", now at " << fEvtStartIdx+fEventCounter << G4endl;
-
-  G4int currentIdx = fEvtStartIdx+fEventCounter;
-  anEvent->SetEventID(currentIdx);
+  G4int currentIdx = fEntries.Entry(fEventCounter);
 
-  if ( currentIdx >= fNEntries ) {
-    G4cerr << "** event index beyond range !! **" << G4endl;
+  G4cout << "oooOOOooo Event # " << fEventCounter << " oooOOOooo" << G4endl;
+  G4cout << "GeneratePrimaries from file " << fGSTFilename << ", evtID starts from "<< fEntries.first << ", now at " << currentIdx << G4endl;
+
+  // selected entries exhausted: stop the run here
+  if ( currentIdx >= fEntries.end ) {
+    G4cout << "GENIEGenerator: no more entries in the selected range [" << fEntries.first << ", " << fEntries.end 
+           << "). run terminated..." << G4endl;
+    G4RunManager::GetRunManager()->AbortRun();
+    return;
   }
+  anEvent->SetEventID(currentIdx);
   
   // fetch a single entry from GENIE input file
   fGSTTree->GetEntry(currentIdx); 
 
+  // bytes are read from the file cluster by cluster, so this is mostly zero
+  // with occasional cache refills
+  Long64_t bytesRead = fGSTFile->GetBytesRead();
+  G4cout << "GENIEGenerator: read " << (bytesRead - fBytesRead) << " bytes for this event (" 
+         << bytesRead/(fEventCounter+1) << " bytes/event on average)" << G4endl;
+  fBytesRead = bytesRead;
+
   // compute/repackage what is not directly available from the tree
   // position is randomly extracted in the detector fiducial volume
   // or set to the center according to config parameter 
@@ -169,9 +192,8 @@ void GENIEGenerator::GeneratePrimaries(G4Event* anEvent)
   G4LorentzVector neuX4;
 
 
-  // G4Random::setTheSeed(currentIdx+1);
   if(fRandomVtx){
-    G4ThreeVector rdm_vtx = GenerateRandomPoint(currentIdx);
+    G4ThreeVector rdm_vtx = fVertexSampler->Sample(currentIdx);
     neuX4.setX(rdm_vtx.x());
     neuX4.setY(rdm_vtx.y());
     neuX4.setZ(rdm_vtx.z());
@@ -189,8 +211,9 @@ void GENIEGenerator::GeneratePrimaries(G4Event* anEvent)
   G4PrimaryVertex* vtx = new G4PrimaryVertex(neuX4.x(), neuX4.y(), neuX4.z(), neuX4.t()); 
   // now add all the final state particles into the vertex
   // - final state lepton (if NC, it's the neutrino!)
-  G4ParticleDefinition* particleDefinition;
-  if ( FindParticleDefinition(m_fslPDG, particleDefinition) ){
+  ParticleDefinitionCache* particleCache = ParticleDefinitionCache::GetInstance();
+  G4ParticleDefinition* particleDefinition = particleCache->Find(m_fslPDG);
+  if ( particleDefinition ){
 
     G4PrimaryParticle* plepton = new G4PrimaryParticle(particleDefinition, fslP4.x(), fslP4.y(), fslP4.z(), fslP4.e());
     /* G4cout << "Lepton PDG " << m_fslPDG << " mass " << particleDefinition->GetPDGMass()*MeV << G4endl;
@@ -204,7 +227,8 @@ void GENIEGenerator::GeneratePrimaries(G4Event* anEvent)
   for (int ipar=0; ipar<m_nf; ++ipar) {
 
     G4LorentzVector p( m_pxf[ipar]*GeV, m_pyf[ipar]*GeV, m_pzf[ipar]*GeV, m_Ef[ipar]*GeV );
-    if ( !FindParticleDefinition( m_pdgf[ipar], particleDefinition) ) continue; //skip bad pdgs
+    particleDefinition = particleCache->Find(m_pdgf[ipar]);
+    if ( !particleDefinition ) continue; //skip bad pdgs, counted by the cache
     G4PrimaryParticle* prim = new G4PrimaryParticle(particleDefinition, p.x(), p.y(), p.z(), p.t()); 
     /* G4cout << "Particle PDG " << m_pdgf[ipar] << " mass " << particleDefinition->GetPDGMass()*MeV << G4endl;
     G4cout << "p4  " << p.X() << " " << p.Y() << " " << p.Z() << " " << p.E() << G4endl;
@@ -332,44 +356,3 @@ G4String GENIEGenerator::EncodeProcessName() const
 
   return process;
 }
-
-
-
-G4ThreeVector GENIEGenerator::GenerateRandomPoint(G4int currentIdx) const {
-  auto *runManager = G4RunManager::GetRunManager();
-  auto detector = (DetectorConstruction*) (runManager->GetUserDetectorConstruction());
-
-  auto volumes = detector->GetTargetPhysVols();
-
-  if (volumes.empty()) return G4ThreeVector();
-
-  // Step 1: Randomly pick a volume
-  size_t index = static_cast<size_t>(G4UniformRand() * volumes.size());
-  G4VPhysicalVolume* physVol = volumes[index];
-
-  // Step 2: Get the solid
-  G4LogicalVolume* logVol = physVol->GetLogicalVolume();
-  G4VSolid* solid = logVol->GetSolid();
-  const G4Box* box = dynamic_cast<const G4Box*>(solid);
-  if (!box) {
-    G4Exception("SamplePointInSolid", "InvalidSolid", FatalException,
-                "Only G4Box supported in this example.");
-  }
-
-  G4double dx = box->GetXHalfLength();
-  G4double dy = box->GetYHalfLength();
-  G4double dz = box->GetZHalfLength();
-
-  G4Random::setTheSeed(currentIdx+1);
-  G4ThreeVector point;
-  do {
-    point = G4ThreeVector(
-      (2 * G4UniformRand() - 1) * dx,
-      (2 * G4UniformRand() - 1) * dy,
-      (2 * G4UniformRand() - 1) * dz
-    );
-  } while (solid->Inside(point) != kInside);
-
-  // Transform to global coordinates
-  return physVol->GetObjectTranslation() + point;
-}
\ No newline at end of file
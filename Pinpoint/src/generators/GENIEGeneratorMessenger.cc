@@ -1,13 +1,12 @@
 #include "generators/GENIEGeneratorMessenger.hh"
 #include "generators/GENIEGenerator.hh"
+#include "generators/EntrySelectionCommands.hh"
 
 #include "G4UIdirectory.hh"
-#include "G4UIcommand.hh"
 #include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWithAnInteger.hh"
 #include "G4UIcmdWithABool.hh"
 
-
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 GENIEGeneratorMessenger::GENIEGeneratorMessenger(GENIEGenerator* action) 
@@ -29,6 +28,41 @@ GENIEGeneratorMessenger::GENIEGeneratorMessenger(GENIEGenerator* action)
   fRandomVtxCmd->SetGuidance("set random vertex in fiducial volume");
   fRandomVtxCmd->SetDefaultValue(false);
 
+  fVtxWeightingCmd = new G4UIcmdWithAString("/gen/genie/vtxWeighting", this);
+  fVtxWeightingCmd->SetGuidance("weight the target volumes by mass or by volume when sampling random vertices");
+  fVtxWeightingCmd->SetParameterName("weighting", false);
+  fVtxWeightingCmd->SetCandidates("mass volume");
+  fVtxWeightingCmd->SetDefaultValue("mass");
+  fVtxWeightingCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fVtxSeedCmd = new G4UIcmdWithAnInteger("/gen/genie/vtxSeed", this);
+  fVtxSeedCmd->SetGuidance("set the seed of the random vertex sampler, combined with /random/masterSeed and the entry index for each event");
+  fVtxSeedCmd->SetParameterName("seed", false);
+  fVtxSeedCmd->SetDefaultValue((G4int)0);
+  fVtxSeedCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fCacheSizeCmd = new G4UIcmdWithAnInteger("/gen/genie/cacheSize", this);
+  fCacheSizeCmd->SetGuidance("set the TTreeCache size in MB used to read the gst tree (0 disables the cache)");
+  fCacheSizeCmd->SetParameterName("cacheSize", false);
+  fCacheSizeCmd->SetRange("cacheSize>=0");
+  fCacheSizeCmd->SetDefaultValue((G4int)30);
+  fCacheSizeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fCacheLearnEntriesCmd = new G4UIcmdWithAnInteger("/gen/genie/cacheLearnEntries", this);
+  fCacheLearnEntriesCmd->SetGuidance("set the number of entries the TTreeCache uses to learn which branches are read");
+  fCacheLearnEntriesCmd->SetParameterName("cacheLearnEntries", false);
+  fCacheLearnEntriesCmd->SetRange("cacheLearnEntries>0");
+  fCacheLearnEntriesCmd->SetDefaultValue((G4int)10);
+  fCacheLearnEntriesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fPrefetchCmd = new G4UIcmdWithABool("/gen/genie/prefetch", this);
+  fPrefetchCmd->SetGuidance("prefetch the next cache cluster in a background thread");
+  fPrefetchCmd->SetParameterName("prefetch", true);
+  fPrefetchCmd->SetDefaultValue(true);
+  fPrefetchCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fEntrySelectionCmds = new EntrySelectionCommands(this, "/gen/genie/", "gst entries");
+
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -38,6 +72,12 @@ GENIEGeneratorMessenger::~GENIEGeneratorMessenger()
   delete fGSTInputFileCmd;
   delete fGSTEvtStartIdxCmd;
   delete fRandomVtxCmd;
+  delete fVtxWeightingCmd;
+  delete fVtxSeedCmd;
+  delete fCacheSizeCmd;
+  delete fCacheLearnEntriesCmd;
+  delete fPrefetchCmd;
+  delete fEntrySelectionCmds;
   delete fGENIEGeneratorDir;
 }
 
@@ -48,6 +88,27 @@ void GENIEGeneratorMessenger::SetNewValue(G4UIcommand* command, G4String newValu
   if (command == fGSTInputFileCmd) fGENIEAction->SetGSTFilename(newValues);
   else if (command == fGSTEvtStartIdxCmd) fGENIEAction->SetEvtStartIdx(fGSTEvtStartIdxCmd->GetNewIntValue(newValues));
   else if (command == fRandomVtxCmd) fGENIEAction->SetRandomVertex(fRandomVtxCmd->GetNewBoolValue(newValues));
+  else if (command == fVtxWeightingCmd) fGENIEAction->SetVertexWeighting(newValues);
+  else if (command == fVtxSeedCmd) fGENIEAction->SetVertexSeed(fVtxSeedCmd->GetNewIntValue(newValues));
+  else if (command == fCacheSizeCmd) fGENIEAction->SetCacheSize(fCacheSizeCmd->GetNewIntValue(newValues));
+  else if (command == fCacheLearnEntriesCmd) fGENIEAction->SetCacheLearnEntries(fCacheLearnEntriesCmd->GetNewIntValue(newValues));
+  else if (command == fPrefetchCmd) fGENIEAction->SetPrefetch(fPrefetchCmd->GetNewBoolValue(newValues));
+  else fEntrySelectionCmds->Apply(command, newValues, fGENIEAction);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String GENIEGeneratorMessenger::GetCurrentValue(G4UIcommand* command)
+{
+  if (command == fGSTInputFileCmd) return fGENIEAction->GetGSTFilename();
+  if (command == fGSTEvtStartIdxCmd) return fGSTEvtStartIdxCmd->ConvertToString(fGENIEAction->GetEvtStartIdx());
+  if (command == fRandomVtxCmd) return fRandomVtxCmd->ConvertToString(fGENIEAction->GetRandomVertex());
+  if (command == fVtxWeightingCmd) return fGENIEAction->GetVertexWeighting();
+  if (command == fVtxSeedCmd) return fVtxSeedCmd->ConvertToString(static_cast<G4int>(fGENIEAction->GetVertexSeed()));
+  if (command == fCacheSizeCmd) return fCacheSizeCmd->ConvertToString(fGENIEAction->GetCacheSize());
+  if (command == fCacheLearnEntriesCmd) return fCacheLearnEntriesCmd->ConvertToString(fGENIEAction->GetCacheLearnEntries());
+  if (command == fPrefetchCmd) return fPrefetchCmd->ConvertToString(fGENIEAction->GetPrefetch());
+  return fEntrySelectionCmds->GetCurrentValue(command, fGENIEAction);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,271 @@
+#include "generators/GeneratorBase.hh"
+#include "generators/GFaserGenerator.hh"
+#include "generators/GFaserGeneratorMessenger.hh"
+#include "generators/GeneratorVertexMetadata.hh"
+#include "generators/ParticleDefinitionCache.hh"
+#include "DetectorConstruction.hh"
+
+#include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4PhysicalConstants.hh"
+#include "G4Exception.hh"
+#include "G4RunManager.hh"
+
+#include "TBranch.h"
+#include "TLeaf.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <type_traits>
+
+namespace {
+  // ROOT names of the types of the gFaser branches
+  template <typename T> const char* LeafTypeName() { return std::is_same<T, G4int>::value ? "Int_t" : "Double_t"; }
+  template <typename T> const char* VectorClassName() { return std::is_same<T, G4int>::value ? "vector<int>" : "vector<double>"; }
+}
+
+GFaserGenerator::GFaserGenerator()
+{
+  fGeneratorName = "gfaser";
+  fMessenger = new GFaserGeneratorMessenger(this);
+
+  fFile = nullptr;
+  fTree = nullptr;
+  fCacheSize = 30;
+  fListsAreVectors = false;
+  m_n = 0;
+
+  fEventCounter = 0;
+  fEvtStartIdx = 0;
+  fEvtCount = -1;
+  fShardIdx = 0;
+  fNShards = 1;
+  fShardStrided = false;
+
+  fVtxOffset = G4ThreeVector(0,0,0);
+  fRandomVtx = false;
+  fVtxSeed = 0;
+  fVertexSampler = nullptr;
+}
+
+GFaserGenerator::~GFaserGenerator()
+{
+  delete fVertexSampler;
+  delete fTree;
+  if(fFile) fFile->Close();
+  delete fMessenger;
+}
+
+TBranch* GFaserGenerator::GetBranch(const char* name) const
+{
+  TBranch* branch = fTree->GetBranch(name);
+  if (!branch) {
+    G4String err = "No branch " + G4String(name) + " in the gFaser tree of " + fFilename;
+    G4Exception("GFaserGenerator", "FileError", FatalErrorInArgument, err.c_str());
+  }
+  return branch;
+}
+
+template <typename T>
+void GFaserGenerator::SetScalarBranch(const char* name, T* address)
+{
+  TBranch* branch = GetBranch(name);
+  TLeaf* leaf = static_cast<TLeaf*>(branch->GetListOfLeaves()->At(0));
+  if (branch->GetClassName()[0] != '\0' || !leaf || leaf->GetLenStatic() != 1 || leaf->GetLeafCount() ||
+      G4String(leaf->GetTypeName()) != LeafTypeName<T>()) {
+    G4String err = "Branch " + G4String(name) + " of the gFaser tree in " + fFilename + " is not a single " + LeafTypeName<T>();
+    G4Exception("GFaserGenerator", "FileError", FatalErrorInArgument, err.c_str());
+  }
+  fTree->SetBranchStatus(name, 1);
+  fTree->SetBranchAddress(name, address);
+}
+
+template <typename T>
+void GFaserGenerator::SetListBranch(const char* name, std::vector<T>& list, std::size_t nMax)
+{
+  TBranch* branch = GetBranch(name);
+  const G4String className = branch->GetClassName();
+  TLeaf* leaf = static_cast<TLeaf*>(branch->GetListOfLeaves()->At(0));
+  G4bool ok;
+  if (fListsAreVectors) {
+    ok = (className == VectorClassName<T>());
+  } else {
+    ok = className.empty() && leaf && leaf->GetLeafCount() && G4String(leaf->GetTypeName()) == LeafTypeName<T>();
+  }
+  if (!ok) {
+    G4String err = "Branch " + G4String(name) + " of the gFaser tree in " + fFilename + " is not a " +
+                   (fListsAreVectors ? G4String(VectorClassName<T>()) : G4String(LeafTypeName<T>()) + "[n] array") +
+                   " like the pdgc branch, but a " + (className.empty() && leaf ? G4String(leaf->GetTypeName()) : className);
+    G4Exception("GFaserGenerator", "FileError", FatalErrorInArgument, err.c_str());
+  }
+
+  fTree->SetBranchStatus(name, 1);
+  if (fListsAreVectors) {
+    // ROOT fills the vector behind the address in place
+    std::vector<T>** address;
+    if constexpr (std::is_same<T, G4int>::value) {
+      fIntListAddresses.push_back(&list);
+      address = &fIntListAddresses.back();
+    } else {
+      fDoubleListAddresses.push_back(&list);
+      address = &fDoubleListAddresses.back();
+    }
+    fTree->SetBranchAddress(name, address);
+  } else {
+    list.assign(nMax, T(0));
+    fTree->SetBranchAddress(name, list.data());
+  }
+}
+
+void GFaserGenerator::LoadData()
+{
+  fFile = new TFile(fFilename, "read");
+  if (!fFile->IsOpen()) {
+    G4String err = "Cannot open gFaser file : " + fFilename;
+    G4Exception("GFaserGenerator", "FileError", FatalErrorInArgument, err.c_str());
+  }
+
+  fTree = (TTree*)fFile->Get("gFaser");
+  if (!fTree) {
+    G4String err = "No gFaser tree in input file : " + fFilename;
+    G4Exception("GFaserGenerator", "FileError", FatalErrorInArgument, err.c_str());
+  }
+
+  G4long nEntries = fTree->GetEntries();
+  G4cout << "Input gFaser tree has " << nEntries << ((nEntries==1)? " entry." : " entries.") << G4endl;
+  fEntries = EntrySelection::Resolve(nEntries, fEvtStartIdx, fEvtCount, fShardIdx, fNShards, fShardStrided);
+  G4cout << "GFaserGenerator: shard " << fShardIdx << "/" << fNShards << (fShardStrided ? " (strided)" : "") 
+         << " reads entries [" << fEntries.first << ", " << fEntries.end << ") with stride " << fEntries.stride << G4endl;
+
+  // the particle lists are std::vector branches, or arrays counted by n that
+  // are read into buffers sized once for the largest event record
+  fTree->SetBranchStatus("*", 0);
+  fListsAreVectors = (GetBranch("pdgc")->GetClassName()[0] != '\0');
+  std::size_t nMax = 0;
+  if (!fListsAreVectors) {
+    SetScalarBranch("n", &m_n);
+    nMax = std::max<std::size_t>(1, static_cast<std::size_t>(fTree->GetMaximum("n")));
+  }
+  G4cout << "GFaserGenerator: particle lists stored as " << (fListsAreVectors ? "std::vector" : "arrays") << G4endl;
+
+  SetListBranch("pdgc", m_pdgc, nMax);
+  SetListBranch("status", m_status, nMax);
+  SetListBranch("firstMother", m_firstMother, nMax);
+  SetListBranch("lastMother", m_lastMother, nMax);
+  SetListBranch("firstDaughter", m_firstDaughter, nMax);
+  SetListBranch("lastDaughter", m_lastDaughter, nMax);
+  SetListBranch("px", m_px, nMax); // GeV
+  SetListBranch("py", m_py, nMax);
+  SetListBranch("pz", m_pz, nMax);
+  SetListBranch("E", m_E, nMax);
+  SetListBranch("M", m_M, nMax);
+  SetScalarBranch("vx", &m_vx); // m
+  SetScalarBranch("vy", &m_vy);
+  SetScalarBranch("vz", &m_vz);
+
+  // read the input in large clusters through a TTreeCache
+  if (fCacheSize > 0) {
+    fTree->SetCacheSize(static_cast<Long64_t>(fCacheSize) * 1024 * 1024);
+    fTree->AddBranchToCache("*", kFALSE);
+    fTree->StopCacheLearningPhase();
+    fTree->SetCacheEntryRange(fEntries.first, fEntries.end);
+  }
+
+  // vertices are sampled in the target (absorber) volumes of the detector
+  if (fRandomVtx) {
+    auto detector = (DetectorConstruction*) (G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+    fVertexSampler = new VertexSampler(detector->GetTargetPhysVols(), VertexSampler::Weighting::Mass, fVtxSeed);
+  }
+}
+
+void GFaserGenerator::GeneratePrimaries(G4Event* anEvent)
+{
+  // complete line from PrimaryGeneratorAction...
+  G4cout << ") : gFaser Generator ===oooOOOooo===" << G4endl;
+
+  G4long currentIdx = fEntries.Entry(fEventCounter);
+  G4cout << "oooOOOooo Event # " << fEventCounter << " oooOOOooo" << G4endl;
+  G4cout << "GeneratePrimaries from file " << fFilename << ", entry " << currentIdx << G4endl;
+
+  // selected entries exhausted: stop the run here
+  if ( currentIdx >= fEntries.end ) {
+    G4cout << "GFaserGenerator: no more entries in the selected range [" << fEntries.first << ", " << fEntries.end 
+           << "). run terminated..." << G4endl;
+    G4RunManager::GetRunManager()->AbortRun();
+    return;
+  }
+  anEvent->SetEventID(currentIdx);
+  fTree->GetEntry(currentIdx);
+  fEventCounter++;
+
+  // vector branches carry their own length, every list must have it
+  if (fListsAreVectors) {
+    m_n = static_cast<G4int>(m_pdgc.size());
+    for (std::size_t size : {m_status.size(), m_firstMother.size(), m_lastMother.size(), m_firstDaughter.size(),
+                             m_lastDaughter.size(), m_px.size(), m_py.size(), m_pz.size(), m_E.size(), m_M.size()}) {
+      if (size != m_pdgc.size()) {
+        G4String err = "Particle lists of different lengths in entry " + std::to_string(currentIdx) + " of " + fFilename;
+        G4Exception("GFaserGenerator", "FileError", FatalErrorInArgument, err.c_str());
+      }
+    }
+  }
+
+  // vertex position: as in the conversion to HepMC, the time is taken from z (axial timing)
+  G4LorentzVector x4(m_vx*m + fVtxOffset.x(), m_vy*m + fVtxOffset.y(), m_vz*m + fVtxOffset.z(), m_vz*m/c_light);
+  if (fRandomVtx) {
+    G4ThreeVector rdm_vtx = fVertexSampler->Sample(currentIdx);
+    x4.set(rdm_vtx.x(), rdm_vtx.y(), rdm_vtx.z(), 0.);
+  }
+  G4PrimaryVertex* vtx = new G4PrimaryVertex(x4.x(), x4.y(), x4.z(), x4.t());
+
+  GeneratorVertexMetadata metadata;
+  metadata.generatorType = fGeneratorName;
+  metadata.processName = "gFaser";
+  metadata.x4 = x4;
+
+  ParticleDefinitionCache* particleCache = ParticleDefinitionCache::GetInstance();
+  for (G4int i = 0; i < m_n; ++i) {
+    G4int pdg = m_pdgc[i];
+    G4int mother = m_firstMother[i];
+    G4bool fromNeutrino = (mother >= 0 && mother < m_n && 
+                           (std::abs(m_pdgc[mother]) == 12 || std::abs(m_pdgc[mother]) == 14 || std::abs(m_pdgc[mother]) == 16));
+
+    // initial state: incoming neutrino and target
+    if (m_status[i] == 0) {
+      if (std::abs(pdg) == 12 || std::abs(pdg) == 14 || std::abs(pdg) == 16) {
+        metadata.pdg = pdg;
+        metadata.p4 = G4LorentzVector(m_px[i]*GeV, m_py[i]*GeV, m_pz[i]*GeV, m_E[i]*GeV);
+        metadata.mass = 0.;
+        metadata.charge = 0.;
+      } else if (pdg > 1000000000 && metadata.tgt_pdg < 0) {
+        metadata.tgt_pdg = pdg;
+        metadata.tgt_Z = (pdg % 10000000) / 10000;
+        metadata.tgt_A = (pdg % 10000) / 10;
+      }
+      continue;
+    }
+
+    // only stable final state particles are tracked
+    if (m_status[i] != 1) continue;
+
+    // primary lepton: the stable lepton coming from the neutrino (the neutrino itself for NC)
+    if (fromNeutrino && std::abs(pdg) >= 11 && std::abs(pdg) <= 16) metadata.fsl_pdg = pdg;
+
+    G4ParticleDefinition* particleDefinition = particleCache->Find(pdg);
+    if ( !particleDefinition ) continue; //skip bad pdgs, counted by the cache
+    G4PrimaryParticle* prim = new G4PrimaryParticle(particleDefinition, m_px[i]*GeV, m_py[i]*GeV, m_pz[i]*GeV, m_E[i]*GeV);
+    vtx->SetPrimary(prim);
+  }
+
+  // there are no interaction flags in the gFaser tree: CC if the primary lepton is charged
+  if (metadata.fsl_pdg != -1) {
+    G4int fsl = std::abs(metadata.fsl_pdg);
+    metadata.intType = (fsl == 11 || fsl == 13 || fsl == 15) ? 2 /*kIntWeakCC*/ : 3 /*kIntWeakNC*/;
+  }
+  fVertexMetadata.push_back(metadata);
+
+  anEvent->AddPrimaryVertex(vtx);
+}
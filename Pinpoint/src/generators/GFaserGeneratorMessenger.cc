@@ -0,0 +1,87 @@
+#include "generators/GFaserGeneratorMessenger.hh"
+#include "generators/GFaserGenerator.hh"
+#include "generators/EntrySelectionCommands.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWith3VectorAndUnit.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+GFaserGeneratorMessenger::GFaserGeneratorMessenger(GFaserGenerator* action) 
+  : fGFaserAction(action) 
+{
+  fGFaserGeneratorDir = new G4UIdirectory("/gen/gfaser/");
+  fGFaserGeneratorDir->SetGuidance("gFaser (GENIE) generator control");
+
+  fInputFileCmd = new G4UIcmdWithAString("/gen/gfaser/input", this);
+  fInputFileCmd->SetGuidance("set input filename of the gFaser generator");
+  fInputFileCmd->AvailableForStates(G4State_PreInit, G4State_Init, G4State_Idle);
+
+  fVertexOffsetCmd = new G4UIcmdWith3VectorAndUnit("/gen/gfaser/vtxOffset", this);
+  fVertexOffsetCmd->SetGuidance("set the offset added to the vertex position read from the file");
+  fVertexOffsetCmd->SetParameterName("x", "y", "z", false, false);
+  fVertexOffsetCmd->SetUnitCandidates("mm m cm");
+  fVertexOffsetCmd->SetDefaultUnit("mm");
+  fVertexOffsetCmd->AvailableForStates(G4State_PreInit, G4State_Init, G4State_Idle);
+
+  fRandomVtxCmd = new G4UIcmdWithABool("/gen/gfaser/randomVtx", this);
+  fRandomVtxCmd->SetGuidance("ignore the vertex in the file and sample it in the target volumes, weighted by mass");
+  fRandomVtxCmd->SetDefaultValue(false);
+
+  fVtxSeedCmd = new G4UIcmdWithAnInteger("/gen/gfaser/vtxSeed", this);
+  fVtxSeedCmd->SetGuidance("set the seed of the random vertex sampler, combined with /random/masterSeed and the entry index for each event");
+  fVtxSeedCmd->SetParameterName("seed", false);
+  fVtxSeedCmd->SetDefaultValue((G4int)0);
+  fVtxSeedCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fCacheSizeCmd = new G4UIcmdWithAnInteger("/gen/gfaser/cacheSize", this);
+  fCacheSizeCmd->SetGuidance("set the TTreeCache size in MB used to read the gFaser tree (0 disables the cache)");
+  fCacheSizeCmd->SetParameterName("cacheSize", false);
+  fCacheSizeCmd->SetRange("cacheSize>=0");
+  fCacheSizeCmd->SetDefaultValue((G4int)30);
+  fCacheSizeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fEntrySelectionCmds = new EntrySelectionCommands(this, "/gen/gfaser/", "gFaser entries");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+GFaserGeneratorMessenger::~GFaserGeneratorMessenger()
+{
+  delete fInputFileCmd;
+  delete fVertexOffsetCmd;
+  delete fRandomVtxCmd;
+  delete fVtxSeedCmd;
+  delete fCacheSizeCmd;
+  delete fEntrySelectionCmds;
+  delete fGFaserGeneratorDir;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void GFaserGeneratorMessenger::SetNewValue(G4UIcommand* command, G4String newValues)
+{
+  if (command == fInputFileCmd) fGFaserAction->SetFilename(newValues);
+  else if (command == fVertexOffsetCmd) fGFaserAction->SetVertexOffset(fVertexOffsetCmd->GetNew3VectorValue(newValues));
+  else if (command == fRandomVtxCmd) fGFaserAction->SetRandomVertex(fRandomVtxCmd->GetNewBoolValue(newValues));
+  else if (command == fVtxSeedCmd) fGFaserAction->SetVertexSeed(fVtxSeedCmd->GetNewIntValue(newValues));
+  else if (command == fCacheSizeCmd) fGFaserAction->SetCacheSize(fCacheSizeCmd->GetNewIntValue(newValues));
+  else fEntrySelectionCmds->Apply(command, newValues, fGFaserAction);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String GFaserGeneratorMessenger::GetCurrentValue(G4UIcommand* command)
+{
+  if (command == fInputFileCmd) return fGFaserAction->GetFilename();
+  if (command == fVertexOffsetCmd) return fVertexOffsetCmd->ConvertToString(fGFaserAction->GetVertexOffset(), "mm");
+  if (command == fRandomVtxCmd) return fRandomVtxCmd->ConvertToString(fGFaserAction->GetRandomVertex());
+  if (command == fVtxSeedCmd) return fVtxSeedCmd->ConvertToString(static_cast<G4int>(fGFaserAction->GetVertexSeed()));
+  if (command == fCacheSizeCmd) return fCacheSizeCmd->ConvertToString(fGFaserAction->GetCacheSize());
+  return fEntrySelectionCmds->GetCurrentValue(command, fGFaserAction);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
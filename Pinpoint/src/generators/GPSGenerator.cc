@@ -6,7 +6,6 @@
 #include "G4SystemOfUnits.hh"
 #include "G4ParticleTable.hh"
 #include "G4LorentzVector.hh"
-#include "Randomize.hh"
 
 GPSGenerator::GPSGenerator()
 {
@@ -22,18 +21,10 @@ GPSGenerator::GPSGenerator()
   fGPS->SetParticleDefinition(myParticle);
   fGPS->GetCurrentSource()->GetEneDist()->SetMonoEnergy(5*GeV);  // kinetic energy
   fGPS->GetCurrentSource()->GetAngDist()->SetParticleMomentumDirection(G4ThreeVector(0,0,1));
-  G4long seeds[2];
-  time_t systime = time(NULL);
-  seeds[0] = (G4long) systime;
-  seeds[1] = (G4long) (systime*G4UniformRand());
-  G4Random::setTheSeeds(seeds);
-  G4Random::showEngineStatus();
-  G4double x0 = G4UniformRand();
-  G4double y0 = G4UniformRand();
-  G4double z0 = G4UniformRand();
-  x0 = 0*mm;
-  y0 = 0*mm;
-  z0 = 0*m;
+  // the engine is seeded per event by SeedService
+  G4double x0 = 0*mm;
+  G4double y0 = 0*mm;
+  G4double z0 = 0*m;
   fGPS->GetCurrentSource()->GetPosDist()->SetPosDisType("Point");
   fGPS->GetCurrentSource()->GetPosDist()->SetCentreCoords(G4ThreeVector(x0, y0, z0));
 
@@ -0,0 +1,108 @@
+#include "generators/HepMCEventIndex.hh"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sys/stat.h>
+
+// sidecar layout: magic, input size, input mtime, number of events, offsets
+static const char kIndexMagic[8] = {'P','P','H','M','C','I','X','1'};
+
+HepMCEventIndex::HepMCEventIndex(const G4String& filename)
+  : fFilename(filename), fIndexFilename(filename + ".idx"), fFileSize(0), fFileMTime(0)
+{}
+
+G4bool HepMCEventIndex::Load()
+{
+  struct stat st;
+  if (stat(fFilename.c_str(), &st) != 0) return false;
+  fFileSize = st.st_size;
+  fFileMTime = st.st_mtime;
+
+  if (ReadSidecar()) {
+    G4cout << "HepMCEventIndex: loaded " << fOffsets.size() << " event offsets from " << fIndexFilename << G4endl;
+    return true;
+  }
+
+  G4cout << "HepMCEventIndex: indexing " << fFilename << " ..." << G4endl;
+  if (!Build()) return false;
+  G4cout << "HepMCEventIndex: found " << fOffsets.size() << " events" << G4endl;
+  WriteSidecar();
+  return true;
+}
+
+G4bool HepMCEventIndex::ReadSidecar()
+{
+  std::ifstream in(fIndexFilename, std::ios::binary);
+  if (!in) return false;
+
+  char magic[8];
+  std::uint64_t size = 0, nEvents = 0;
+  std::int64_t mtime = 0;
+  in.read(magic, sizeof(magic));
+  in.read(reinterpret_cast<char*>(&size), sizeof(size));
+  in.read(reinterpret_cast<char*>(&mtime), sizeof(mtime));
+  in.read(reinterpret_cast<char*>(&nEvents), sizeof(nEvents));
+  if (!in || std::memcmp(magic, kIndexMagic, sizeof(magic)) != 0) return false;
+
+  // input changed since the index was written
+  if (size != fFileSize || mtime != fFileMTime) return false;
+
+  fOffsets.resize(nEvents);
+  in.read(reinterpret_cast<char*>(fOffsets.data()), nEvents*sizeof(std::uint64_t));
+  if (!in) {
+    fOffsets.clear();
+    return false;
+  }
+  return true;
+}
+
+G4bool HepMCEventIndex::Build()
+{
+  std::FILE* file = std::fopen(fFilename.c_str(), "rb");
+  if (!file) return false;
+
+  // scan in large blocks for "E " at the start of a line
+  const std::size_t blockSize = 1 << 22;
+  std::vector<char> block(blockSize);
+  std::uint64_t blockStart = 0;
+  char prev = '\n';        // last character of the previous block
+  G4bool pendingE = false; // previous block ended with "\nE"
+
+  fOffsets.clear();
+  std::size_t n;
+  while ((n = std::fread(block.data(), 1, blockSize, file)) > 0) {
+    const char* data = block.data();
+    if (pendingE && data[0] == ' ') fOffsets.push_back(blockStart - 1);
+    if (prev == '\n' && n > 1 && data[0] == 'E' && data[1] == ' ') fOffsets.push_back(blockStart);
+
+    const char* p = data;
+    const char* last = data + n;
+    while ((p = static_cast<const char*>(std::memchr(p, '\n', last - p)))) {
+      ++p;
+      if (p + 1 < last && p[0] == 'E' && p[1] == ' ') fOffsets.push_back(blockStart + (p - data));
+    }
+
+    pendingE = (n > 1 && data[n-2] == '\n' && data[n-1] == 'E') || (n == 1 && prev == '\n' && data[0] == 'E');
+    prev = data[n-1];
+    blockStart += n;
+  }
+  std::fclose(file);
+  return true;
+}
+
+void HepMCEventIndex::WriteSidecar() const
+{
+  // the input may live on a read-only area: the index is then only kept in memory
+  std::ofstream out(fIndexFilename, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    G4cout << "HepMCEventIndex: cannot write " << fIndexFilename << ", index not cached" << G4endl;
+    return;
+  }
+  std::uint64_t nEvents = fOffsets.size();
+  out.write(kIndexMagic, sizeof(kIndexMagic));
+  out.write(reinterpret_cast<const char*>(&fFileSize), sizeof(fFileSize));
+  out.write(reinterpret_cast<const char*>(&fFileMTime), sizeof(fFileMTime));
+  out.write(reinterpret_cast<const char*>(&nEvents), sizeof(nEvents));
+  out.write(reinterpret_cast<const char*>(fOffsets.data()), nEvents*sizeof(std::uint64_t));
+}
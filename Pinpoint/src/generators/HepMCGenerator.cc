@@ -2,10 +2,21 @@
 #include "generators/HepMCGenerator.hh"
 #include "generators/HepMCGeneratorMessenger.hh"
 #include "generators/GeneratorVertexMetadata.hh"
+#include "generators/HepMCEventIndex.hh"
+#include "generators/ParticleDefinitionCache.hh"
 
 #include "HepMC3/ReaderAscii.h"
 #include "HepMC3/ReaderAsciiHepMC2.h"
 #include <HepMC3/Print.h>
+#ifdef PINPOINT_WITH_HEPMC3_ROOTIO
+#include "HepMC3/ReaderRoot.h"
+#include "HepMC3/ReaderRootTree.h"
+#endif
+#if __has_include("HepMC3/CompressedIO.h")
+#include "HepMC3/CompressedIO.h"
+#endif
+
+#include "TFile.h"
 
 #include "G4PhysicalConstants.hh"
 #include "G4SystemOfUnits.hh"
@@ -15,6 +26,12 @@
 #include "G4RunManager.hh"
 #include "G4PhysicalVolumeStore.hh"
 #include "G4Box.hh"
+#include "G4ParticleDefinition.hh"
+
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <memory>
 
 
 HepMCGenerator::HepMCGenerator()
@@ -22,37 +39,212 @@ HepMCGenerator::HepMCGenerator()
   fGeneratorName = "hepmc";
   fMessenger = new HepMCGeneratorMessenger(this);
 
-  fAsciiInput = nullptr;
+  fHepMCInput = nullptr;
+  fInputFormat = "auto";
   fVtxOffset = G4ThreeVector(0,0,0);
   fUseHepMC2 = false;
+
+  fFirstEvent = 0;
+  fNEvents = -1;
+  fShardIdx = 0;
+  fNShards = 1;
+  fShardStrided = false;
+  fEventCounter = 0;
+  fNGenerated = 0;
+  fNextEntry = 0;
+  fEventIndex = nullptr;
+  fInputStream = nullptr;
+  fPrefetchDepth = 0;
+  fPrefetchQueue = nullptr;
 }
 
 HepMCGenerator::~HepMCGenerator()
 {
-  delete fAsciiInput;
+  // the reader thread uses the input, stop it first
+  StopPrefetch();
+  delete fHepMCInput;
+  delete fInputStream;
+  delete fEventIndex;
   delete fMessenger;
 }
 
+G4bool HepMCGenerator::IsCompressedInput() const
+{
+  for (const G4String ext : {".gz", ".zst", ".xz", ".bz2"}) {
+    if (fHepMCFilename.size() > ext.size() &&
+        fHepMCFilename.compare(fHepMCFilename.size() - ext.size(), ext.size(), ext) == 0) return true;
+  }
+  return false;
+}
+
+G4String HepMCGenerator::ResolveInputFormat() const
+{
+  if (fInputFormat != "auto") return fInputFormat;
+
+  // ROOT files hold either one object per event (WriterRoot) or a tree (WriterRootTree)
+  const G4String rootExt = ".root";
+  if (fHepMCFilename.size() > rootExt.size() &&
+      fHepMCFilename.compare(fHepMCFilename.size() - rootExt.size(), rootExt.size(), rootExt) == 0) {
+    std::unique_ptr<TFile> file(TFile::Open(fHepMCFilename.c_str(), "READ"));
+    if (file && !file->IsZombie() && file->FindKey("hepmc3_tree")) return "roottree";
+    return "root";
+  }
+
+  return (fUseHepMC2) ? "hepmc2" : "ascii";
+}
+
+HepMC3::Reader* HepMCGenerator::OpenReader(const G4String& format, G4bool compressed)
+{
+  if (format == "root" || format == "roottree") {
+#ifdef PINPOINT_WITH_HEPMC3_ROOTIO
+    if (format == "roottree") return new HepMC3::ReaderRootTree(fHepMCFilename);
+    return new HepMC3::ReaderRoot(fHepMCFilename);
+#else
+    G4Exception("HepMCGenerator", "FormatError", FatalErrorInArgument,
+                "HepMC3 was found without its rootIO library, cannot read ROOT input");
+    return nullptr;
+#endif
+  }
+
+  if (format != "ascii" && format != "hepmc2") {
+    G4String err = "Unknown HepMC input format : " + format;
+    G4Exception("HepMCGenerator", "FormatError", FatalErrorInArgument, err.c_str());
+    return nullptr;
+  }
+
+  if (compressed) {
+#if defined(HEPMC3_USE_COMPRESSION) && HEPMC3_USE_COMPRESSION
+    // decompressed on the fly, the compression type is detected from the file content
+    try {
+      fInputStream = new HepMC3::ifstream(fHepMCFilename);
+    } catch (const std::exception& e) {
+      G4String err = "Cannot decompress HepMC file " + fHepMCFilename + " : " + e.what();
+      G4Exception("HepMCGenerator", "FileError", FatalErrorInArgument, err.c_str());
+    }
+#else
+    G4Exception("HepMCGenerator", "FormatError", FatalErrorInArgument,
+                "built without compression support (HepMC3/CompressedIO.h or the compression libraries were not found), cannot read compressed input");
+#endif
+  } else {
+    fInputStream = new std::ifstream(fHepMCFilename);
+  }
+
+  if (format == "hepmc2") return new HepMC3::ReaderAsciiHepMC2(*fInputStream);
+  return new HepMC3::ReaderAscii(*fInputStream);
+}
+
 void HepMCGenerator::LoadData()
 {   
   // this is called only once from PrimaryGeneratorAction, no need to worry about data bein reloaded anymore
-  // TODO: Would be nice if we could load specific events - no functionallity in HepMC to do this - could make use of `skip` method?
-  
-  fAsciiInput = (fUseHepMC2) 
-              ? static_cast<HepMC3::Reader*>(new HepMC3::ReaderAsciiHepMC2(fHepMCFilename)) 
-              : static_cast<HepMC3::Reader*>(new HepMC3::ReaderAscii(fHepMCFilename));
+  G4String format = ResolveInputFormat();
+  G4bool compressed = IsCompressedInput();
+  G4cout << "HepMCGenerator: reading " << fHepMCFilename << " as " << format 
+         << (compressed ? " (compressed)" : "") << G4endl;
 
-  if( fAsciiInput->failed() ){
+  // HepMC3 readers cannot jump to specific events: for plain ASCII files the byte offset 
+  // of each event is taken from an index and the input stream is seeked there,
+  // the other inputs skip forward through the events
+  G4bool useSelection = (fFirstEvent > 0 || fNShards > 1);
+  G4bool seekable = !compressed && (format == "ascii" || format == "hepmc2");
+
+  if (useSelection && seekable) {
+    fEventIndex = new HepMCEventIndex(fHepMCFilename);
+    if (!fEventIndex->Load()) {
+      G4String err = "Cannot index HepMC file : " + fHepMCFilename;
+      G4Exception("HepMCGenerator", "FileError", FatalErrorInArgument, err.c_str());
+    }
+    fEntries = EntrySelection::Resolve(fEventIndex->GetNEvents(), fFirstEvent, fNEvents, 
+                                       fShardIdx, fNShards, fShardStrided);
+    fNextEntry = -1;
+  } else {
+    // the number of events is not known without reading the whole input
+    if (fNShards > 1 && !fShardStrided && fNEvents < 0) {
+      G4Exception("HepMCGenerator", "InvalidShard", FatalErrorInArgument,
+                  "contiguous shards of compressed or ROOT input need /gen/hepmc/nEvents, or use strided shards");
+    }
+    fEntries = EntrySelection::Resolve(std::numeric_limits<G4long>::max(), fFirstEvent, fNEvents,
+                                       fShardIdx, fNShards, fShardStrided);
+    fNextEntry = 0;
+  }
+
+  if (useSelection) {
+    G4cout << "HepMCGenerator: shard " << fShardIdx << "/" << fNShards << (fShardStrided ? " (strided)" : "") 
+           << " reads events [" << fEntries.first << ", " << fEntries.end << ") with stride " << fEntries.stride << G4endl;
+  }
+
+  fHepMCInput = OpenReader(format, compressed);
+
+  if( !fHepMCInput || fHepMCInput->failed() ){
     G4String err = "Cannot open HepMC file : " + fHepMCFilename;
     G4Exception("HepMCGenerator", "FileError", FatalErrorInArgument, err.c_str());
   }
+
+  if (fPrefetchDepth > 0) {
+    G4cout << "HepMCGenerator: parsing up to " << fPrefetchDepth << " events ahead in a reader thread" << G4endl;
+    fPrefetchQueue = new BoundedQueue<PrefetchedEvent>(fPrefetchDepth);
+    fPrefetchThread = std::thread(&HepMCGenerator::PrefetchLoop, this);
+  }
+}
+
+void HepMCGenerator::PrefetchLoop()
+{
+  // runs in the reader thread, the only one touching the input after LoadData
+  try {
+    while (true) {
+      G4long entry;
+      std::shared_ptr<HepMC3::GenEvent> evt = ReadNextEvent(entry);
+      if (!evt) break;
+      if (!fPrefetchQueue->Push(PrefetchedEvent(entry, evt))) return; // generator is being deleted
+    }
+  } catch (const std::exception& e) {
+    // reported by the consumer as the end of the input
+    std::cerr << "HepMCGenerator: reader thread stopped : " << e.what() << std::endl;
+  }
+  fPrefetchQueue->Close();
+}
+
+void HepMCGenerator::StopPrefetch()
+{
+  if (!fPrefetchQueue) return;
+  fPrefetchQueue->Close();
+  if (fPrefetchThread.joinable()) fPrefetchThread.join();
+  delete fPrefetchQueue;
+  fPrefetchQueue = nullptr;
 }
 
-std::shared_ptr<HepMC3::GenEvent> HepMCGenerator::GenerateHepMCEvent()
+std::shared_ptr<HepMC3::GenEvent> HepMCGenerator::GenerateHepMCEvent(G4long& entry)
+{
+  if (!fPrefetchQueue) return ReadNextEvent(entry);
+
+  PrefetchedEvent next;
+  if (!fPrefetchQueue->Pop(next)) return nullptr;
+  entry = next.first;
+  return next.second;
+}
+
+std::shared_ptr<HepMC3::GenEvent> HepMCGenerator::ReadNextEvent(G4long& entry)
 { 
+  entry = fEntries.Entry(fEventCounter);
+  if (entry >= fEntries.end) return nullptr;
+
+  // move to the event unless the input is already there (sequential reading)
+  if (entry != fNextEntry) {
+    if (fEventIndex) {
+      fInputStream->clear();
+      fInputStream->seekg(fEventIndex->GetOffset(entry));
+    } else if (!fHepMCInput->skip(static_cast<int>(entry - fNextEntry))) {
+      return nullptr;
+    }
+  }
+
   std::shared_ptr<HepMC3::GenEvent> evt = std::make_shared<HepMC3::GenEvent>();
-  fAsciiInput->read_event(*evt);
+  fHepMCInput->read_event(*evt);
+  // failed() is also set when the last event runs into the end of the file
+  if (evt->particles().empty()) return nullptr;
   //// HepMC3::Print::content(*evt);
+
+  fNextEntry = entry + 1;
+  fEventCounter++;
   return evt;
 }
 
@@ -92,19 +284,26 @@ void HepMCGenerator::GeneratePrimaries(G4Event* anEvent)
   G4cout << "GeneratePrimaries from file " << fHepMCFilename << G4endl;
 
   // generate next event
-  std::shared_ptr<HepMC3::GenEvent> HepMCEvent = GenerateHepMCEvent();
+  G4long entry;
+  std::shared_ptr<HepMC3::GenEvent> HepMCEvent = GenerateHepMCEvent(entry);
+  fNGenerated++;
   if(!HepMCEvent) {
     G4cout << "HepMCInterface: no generated particles. run terminated..." << G4endl;
     G4RunManager::GetRunManager()-> AbortRun();
     return;
   }
 
+  // with a selection the event ID is the position of the event in the file
+  if (fFirstEvent > 0 || fNShards > 1) anEvent->SetEventID(entry);
+
   HepMC2G4(HepMCEvent, anEvent);
 }
 
 
 void HepMCGenerator::HepMC2G4(const std::shared_ptr<HepMC3::GenEvent> hepmcevt, G4Event* g4event)
 {
+  ParticleDefinitionCache* particleCache = ParticleDefinitionCache::GetInstance();
+
   for (const auto& vertex : hepmcevt->vertices()) {
 
     // check world boundary
@@ -134,10 +333,11 @@ void HepMCGenerator::HepMC2G4(const std::shared_ptr<HepMC3::GenEvent> hepmcevt,
     for (const auto& particle : vertex->particles_out())  {
       if( particle->status() == 1 ||  particle->status() == 5 )
       {
-        G4int pdgcode = particle->pdg_id();
+        G4ParticleDefinition* definition = particleCache->Find(particle->pdg_id());
+        if (!definition) continue; // counted by the cache
         pos = particle->momentum();
         G4LorentzVector p(pos.px(), pos.py(), pos.pz(), pos.e());
-        G4PrimaryParticle* g4prim = new G4PrimaryParticle(pdgcode, p.x()*GeV, p.y()*GeV, p.z()*GeV);
+        G4PrimaryParticle* g4prim = new G4PrimaryParticle(definition, p.x()*GeV, p.y()*GeV, p.z()*GeV);
         g4vtx->SetPrimary(g4prim);
       }
     }
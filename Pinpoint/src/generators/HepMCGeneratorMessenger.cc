@@ -1,12 +1,12 @@
 #include "generators/HepMCGeneratorMessenger.hh"
 #include "generators/HepMCGenerator.hh"
+#include "generators/EntrySelectionCommands.hh"
 
 #include "G4UIdirectory.hh"
-#include "G4UIcommand.hh"
 #include "G4UIcmdWithAString.hh"
 #include "G4UIcmdWith3VectorAndUnit.hh"
 #include "G4UIcmdWithABool.hh"
-
+#include "G4UIcmdWithAnInteger.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -20,6 +20,15 @@ HepMCGeneratorMessenger::HepMCGeneratorMessenger(HepMCGenerator* action)
   fHepMCInputFileCmd->SetGuidance("set input filename of the HepMC generator");
   fHepMCInputFileCmd->AvailableForStates(G4State_PreInit, G4State_Init, G4State_Idle);
 
+  fHepMCFormatCmd = new G4UIcmdWithAString("/gen/hepmc/format", this);
+  fHepMCFormatCmd->SetGuidance("set the format of the HepMC input file");
+  fHepMCFormatCmd->SetGuidance("auto: ROOT readers for .root files, ASCII (HepMC3 or /gen/hepmc/useHepMC2) otherwise");
+  fHepMCFormatCmd->SetGuidance("ASCII files ending in .gz, .zst, .xz or .bz2 are decompressed while reading");
+  fHepMCFormatCmd->SetParameterName("format", false);
+  fHepMCFormatCmd->SetCandidates("auto ascii hepmc2 root roottree");
+  fHepMCFormatCmd->SetDefaultValue("auto");
+  fHepMCFormatCmd->AvailableForStates(G4State_PreInit, G4State_Init, G4State_Idle);
+
   fHepMCVertexOffsetCmd = new G4UIcmdWith3VectorAndUnit("/gen/hepmc/vtxOffset", this);
   fHepMCVertexOffsetCmd->SetGuidance("set the offset of the primary vertex - useful when there is a mismatch in the geometry");
   fHepMCVertexOffsetCmd->SetParameterName("x", "y", "z", false, false);
@@ -36,6 +45,30 @@ HepMCGeneratorMessenger::HepMCGeneratorMessenger(HepMCGenerator* action)
   fHepMCPlaceInDecayVolumeCmd->SetGuidance("will try and translate vertex into FASER2 decay volume. Note: Assumes that vertices in HepMC start from (0,0,0) - set /hepmc/vtxOffset if not. Also assumes that decay volume lengths match.");
   fHepMCPlaceInDecayVolumeCmd->AvailableForStates(G4State_PreInit, G4State_Init, G4State_Idle);
   fHepMCPlaceInDecayVolumeCmd->SetDefaultValue(true);
+
+  fHepMCFirstEventCmd = new G4UIcmdWithAnInteger("/gen/hepmc/firstEvent", this);
+  fHepMCFirstEventCmd->SetGuidance("set the index of the first event to read from the HepMC file");
+  fHepMCFirstEventCmd->SetGuidance("jumps directly to the event using the <file>.idx offset index (built on first use)");
+  fHepMCFirstEventCmd->SetParameterName("firstEvent", false);
+  fHepMCFirstEventCmd->SetRange("firstEvent>=0");
+  fHepMCFirstEventCmd->SetDefaultValue((G4int)0);
+  fHepMCFirstEventCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fHepMCNEventsCmd = new G4UIcmdWithAnInteger("/gen/hepmc/nEvents", this);
+  fHepMCNEventsCmd->SetGuidance("set the number of events to read from the HepMC file (-1 for all)");
+  fHepMCNEventsCmd->SetParameterName("nEvents", false);
+  fHepMCNEventsCmd->SetDefaultValue((G4int)-1);
+  fHepMCNEventsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fHepMCPrefetchCmd = new G4UIcmdWithAnInteger("/gen/hepmc/prefetch", this);
+  fHepMCPrefetchCmd->SetGuidance("parse events in a reader thread, keeping up to this many events ready (0 to disable)");
+  fHepMCPrefetchCmd->SetParameterName("depth", false);
+  fHepMCPrefetchCmd->SetRange("depth>=0");
+  fHepMCPrefetchCmd->SetDefaultValue((G4int)0);
+  fHepMCPrefetchCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  // /gen/hepmc/range is the same as /gen/hepmc/firstEvent and /gen/hepmc/nEvents
+  fEntrySelectionCmds = new EntrySelectionCommands(this, "/gen/hepmc/", "events");
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -47,6 +80,11 @@ HepMCGeneratorMessenger::~HepMCGeneratorMessenger()
   delete fUseHepMC2Cmd;
   delete fHepMCGeneratorDir;
   delete fHepMCPlaceInDecayVolumeCmd;
+  delete fHepMCFormatCmd;
+  delete fHepMCFirstEventCmd;
+  delete fHepMCNEventsCmd;
+  delete fEntrySelectionCmds;
+  delete fHepMCPrefetchCmd;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -57,6 +95,26 @@ void HepMCGeneratorMessenger::SetNewValue(G4UIcommand* command, G4String newValu
   else if (command == fHepMCVertexOffsetCmd) fHepMCAction->SetHepMCVertexOffset(fHepMCVertexOffsetCmd->GetNew3VectorValue(newValues));
   else if (command == fUseHepMC2Cmd) fHepMCAction->SetUseHepMC2(fUseHepMC2Cmd->GetNewBoolValue(newValues));
   else if (command == fHepMCPlaceInDecayVolumeCmd) fHepMCAction->SetPlaceInDecayVolume(fHepMCPlaceInDecayVolumeCmd->GetNewBoolValue(newValues));
+  else if (command == fHepMCFormatCmd) fHepMCAction->SetInputFormat(newValues);
+  else if (command == fHepMCFirstEventCmd) fHepMCAction->SetFirstEvent(fHepMCFirstEventCmd->GetNewIntValue(newValues));
+  else if (command == fHepMCNEventsCmd) fHepMCAction->SetNEvents(fHepMCNEventsCmd->GetNewIntValue(newValues));
+  else if (command == fHepMCPrefetchCmd) fHepMCAction->SetPrefetchDepth(fHepMCPrefetchCmd->GetNewIntValue(newValues));
+  else fEntrySelectionCmds->Apply(command, newValues, fHepMCAction);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String HepMCGeneratorMessenger::GetCurrentValue(G4UIcommand* command)
+{
+  if (command == fHepMCInputFileCmd) return fHepMCAction->GetHepMCFilename();
+  if (command == fHepMCFormatCmd) return fHepMCAction->GetInputFormat();
+  if (command == fHepMCVertexOffsetCmd) return fHepMCVertexOffsetCmd->ConvertToString(fHepMCAction->GetHepMCVertexOffset(), "mm");
+  if (command == fUseHepMC2Cmd) return fUseHepMC2Cmd->ConvertToString(fHepMCAction->GetUseHepMC2());
+  if (command == fHepMCPlaceInDecayVolumeCmd) return fHepMCPlaceInDecayVolumeCmd->ConvertToString(fHepMCAction->GetPlaceInDecayVolume());
+  if (command == fHepMCFirstEventCmd) return fHepMCFirstEventCmd->ConvertToString(fHepMCAction->GetFirstEvent());
+  if (command == fHepMCNEventsCmd) return fHepMCNEventsCmd->ConvertToString(fHepMCAction->GetNEvents());
+  if (command == fHepMCPrefetchCmd) return fHepMCPrefetchCmd->ConvertToString(fHepMCAction->GetPrefetchDepth());
+  return fEntrySelectionCmds->GetCurrentValue(command, fHepMCAction);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
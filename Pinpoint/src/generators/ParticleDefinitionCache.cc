@@ -0,0 +1,116 @@
+#include "generators/ParticleDefinitionCache.hh"
+
+#include "G4ParticleTable.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4IonTable.hh"
+#include "G4Geantino.hh"
+#include "G4ChargedGeantino.hh"
+
+// unknown pgd codes in GENIE, not processed by Geant4
+// ref: https://internal.dunescience.org/doxygen/ConvertMCTruthToG4_8cxx_source.html
+static const G4int kGeniePseudoLo = 2000000001;
+static const G4int kGeniePseudoHi = 2000000202;
+
+ParticleDefinitionCache* ParticleDefinitionCache::fInstance = nullptr;
+
+ParticleDefinitionCache* ParticleDefinitionCache::GetInstance()
+{
+  if (!fInstance) fInstance = new ParticleDefinitionCache();
+  return fInstance;
+}
+
+ParticleDefinitionCache::ParticleDefinitionCache()
+  : fWarm(false), fDefaultPseudoParticlePolicy(PseudoParticlePolicy::Skip)
+{
+  // This has been a known issue with GENIE: the pseudo-particles (hadronic blob,
+  // bindino, nucleon clusters, ...) only carry bookkeeping information
+  for (G4int pdg : {2000000001, 2000000002, 2000000101, 2000000102, 2000000200, 2000000201, 2000000202}) {
+    fPseudoParticlePolicy[pdg] = PseudoParticlePolicy::Skip;
+  }
+}
+
+void ParticleDefinitionCache::SetPseudoParticlePolicy(G4int pdg, PseudoParticlePolicy policy)
+{
+  fPseudoParticlePolicy[pdg] = policy;
+  fDefinitions.erase(pdg);
+}
+
+void ParticleDefinitionCache::SetPseudoParticlePolicy(PseudoParticlePolicy policy)
+{
+  fDefaultPseudoParticlePolicy = policy;
+  for (auto& [pdg, pdgPolicy] : fPseudoParticlePolicy) pdgPolicy = policy;
+  for (auto it = fDefinitions.begin(); it != fDefinitions.end();) {
+    if (it->first >= kGeniePseudoLo && it->first <= kGeniePseudoHi) it = fDefinitions.erase(it);
+    else ++it;
+  }
+}
+
+ParticleDefinitionCache::PseudoParticlePolicy ParticleDefinitionCache::PolicyFromString(const G4String& name)
+{
+  if (name == "geantino") return PseudoParticlePolicy::Geantino;
+  if (name == "chargedGeantino") return PseudoParticlePolicy::ChargedGeantino;
+  return PseudoParticlePolicy::Skip;
+}
+
+G4String ParticleDefinitionCache::PolicyToString(PseudoParticlePolicy policy)
+{
+  if (policy == PseudoParticlePolicy::Geantino) return "geantino";
+  if (policy == PseudoParticlePolicy::ChargedGeantino) return "chargedGeantino";
+  return "skip";
+}
+
+void ParticleDefinitionCache::Warm()
+{
+  // the particle table is complete once the physics list is constructed,
+  // i.e. before the first event is generated
+  G4ParticleTable::G4PTblDicIterator* it = G4ParticleTable::GetParticleTable()->GetIterator();
+  it->reset();
+  while ((*it)()) {
+    G4ParticleDefinition* def = it->value();
+    if (def->GetPDGEncoding() != 0) fDefinitions.emplace(def->GetPDGEncoding(), def);
+  }
+  fDefinitions[0] = G4ParticleTable::GetParticleTable()->FindParticle("opticalphoton");
+  fWarm = true;
+}
+
+G4ParticleDefinition* ParticleDefinitionCache::Resolve(G4int pdg) const
+{
+  if (pdg >= kGeniePseudoLo && pdg <= kGeniePseudoHi) {
+    auto it = fPseudoParticlePolicy.find(pdg);
+    PseudoParticlePolicy policy = (it != fPseudoParticlePolicy.end()) ? it->second : fDefaultPseudoParticlePolicy;
+    if (policy == PseudoParticlePolicy::Skip) return nullptr;
+    if (policy == PseudoParticlePolicy::Geantino) return G4Geantino::Definition();
+    return G4ChargedGeantino::Definition();
+  }
+
+  G4ParticleDefinition* def = G4ParticleTable::GetParticleTable()->FindParticle(pdg);
+
+  // If the particle is a nucleus and the particle table doesn't have a definition yet, 
+  // ask the ion table for one. This will create a new ion definition as needed.
+  if (!def && pdg > 1000000000) {
+    G4int Z = (pdg % 10000000) / 10000; // atomic number
+    G4int A = (pdg % 10000) / 10;       // mass number
+    def = G4ParticleTable::GetParticleTable()->GetIonTable()->GetIon(Z, A, 0.);
+  }
+  return def;
+}
+
+G4ParticleDefinition* ParticleDefinitionCache::Find(G4int pdg)
+{
+  if (!fWarm) Warm();
+
+  auto it = fDefinitions.find(pdg);
+  if (it == fDefinitions.end()) it = fDefinitions.emplace(pdg, Resolve(pdg)).first;
+
+  if (!it->second) fSkipped[pdg]++;
+  return it->second;
+}
+
+void ParticleDefinitionCache::PrintSkipped() const
+{
+  if (fSkipped.empty()) return;
+  G4cout << "ParticleDefinitionCache: particles not passed to Geant4 (pdg : count)" << G4endl;
+  for (const auto& [pdg, count] : fSkipped) {
+    G4cout << "  " << pdg << " : " << count << G4endl;
+  }
+}
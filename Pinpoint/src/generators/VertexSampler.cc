@@ -0,0 +1,114 @@
+#include "generators/VertexSampler.hh"
+#include "SeedService.hh"
+
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4VPVParameterisation.hh"
+#include "G4VSolid.hh"
+#include "G4Box.hh"
+#include "G4Material.hh"
+#include "G4TransportationManager.hh"
+#include "G4Navigator.hh"
+#include "G4SystemOfUnits.hh"
+#include "G4Exception.hh"
+#include "CLHEP/Random/RandFlat.h"
+
+#include <algorithm>
+#include <cstdint>
+
+VertexSampler::VertexSampler(const std::vector<G4VPhysicalVolume*>& targets, Weighting weighting, G4long seed)
+  : fSeed(seed)
+{
+  G4VPhysicalVolume* world = G4TransportationManager::GetTransportationManager()
+                               ->GetNavigatorForTracking()->GetWorldVolume();
+  Collect(world->GetLogicalVolume(), G4AffineTransform(), targets, weighting);
+
+  if (fInstances.empty()) {
+    G4Exception("VertexSampler", "NoTargets", FatalException, "No target volume found in the geometry.");
+  }
+
+  G4cout << "VertexSampler: " << fInstances.size() << " target placements, total " 
+         << ((weighting == Weighting::Mass) ? "mass " : "volume ") 
+         << ((weighting == Weighting::Mass) ? GetTotalWeight()/kg : GetTotalWeight()/cm3)
+         << ((weighting == Weighting::Mass) ? " kg" : " cm3") << G4endl;
+}
+
+void VertexSampler::Collect(const G4LogicalVolume* mother, const G4AffineTransform& motherToGlobal,
+                            const std::vector<G4VPhysicalVolume*>& targets, Weighting weighting)
+{
+  for (std::size_t i = 0; i < mother->GetNoDaughters(); ++i) {
+    G4VPhysicalVolume* pv = mother->GetDaughter(i);
+    G4bool isTarget = std::find(targets.begin(), targets.end(), pv) != targets.end();
+
+    // transforms of all copies of this daughter, daughter -> mother
+    std::vector<G4AffineTransform> copies;
+    if (!pv->IsReplicated()) {
+      copies.emplace_back(pv->GetRotation(), pv->GetTranslation());
+    } else if (G4VPVParameterisation* param = pv->GetParameterisation()) {
+      for (G4int copy = 0; copy < pv->GetMultiplicity(); ++copy) {
+        param->ComputeTransformation(copy, pv);
+        copies.emplace_back(pv->GetRotation(), pv->GetTranslation());
+      }
+    } else {
+      // replica: copies are evenly spaced along a cartesian axis and centred in the mother
+      EAxis axis;
+      G4int nReplicas;
+      G4double width, offset;
+      G4bool consuming;
+      pv->GetReplicationData(axis, nReplicas, width, offset, consuming);
+      if (axis != kXAxis && axis != kYAxis && axis != kZAxis) {
+        G4String err = "Replica " + pv->GetName() + " is not along a cartesian axis.";
+        G4Exception("VertexSampler", "UnsupportedReplica", FatalException, err.c_str());
+      }
+      for (G4int copy = 0; copy < nReplicas; ++copy) {
+        G4ThreeVector translation;
+        translation[axis - kXAxis] = -0.5*width*(nReplicas-1) + width*copy;
+        copies.emplace_back(G4RotationMatrix(), translation);
+      }
+    }
+
+    for (const auto& toMother : copies) {
+      G4AffineTransform toGlobal = toMother * motherToGlobal;
+      if (isTarget) AddInstance(pv, toGlobal, weighting);
+      else Collect(pv->GetLogicalVolume(), toGlobal, targets, weighting);
+    }
+  }
+}
+
+void VertexSampler::AddInstance(const G4VPhysicalVolume* pv, const G4AffineTransform& toGlobal, Weighting weighting)
+{
+  const G4LogicalVolume* lv = pv->GetLogicalVolume();
+
+  Instance instance;
+  instance.toGlobal = toGlobal;
+  instance.solid = lv->GetSolid();
+  instance.isBox = (dynamic_cast<const G4Box*>(instance.solid) != nullptr);
+  instance.solid->BoundingLimits(instance.boxMin, instance.boxMax);
+  fInstances.push_back(instance);
+
+  G4double weight = instance.solid->GetCubicVolume();
+  if (weighting == Weighting::Mass) weight *= lv->GetMaterial()->GetDensity();
+  fCDF.push_back(GetTotalWeight() + weight);
+}
+
+G4ThreeVector VertexSampler::Sample(G4long key)
+{
+  // nearby keys give unrelated engine seeds, derived from the master seed of the run
+  std::uint64_t seed = SeedService::GetInstance()->StreamSeed(SeedService::kVertexStream, fSeed, key);
+  fEngine.setSeed(static_cast<long>(seed >> 1), 0);
+
+  // pick a placement according to its weight
+  G4double u = CLHEP::RandFlat::shoot(&fEngine) * GetTotalWeight();
+  std::size_t index = std::upper_bound(fCDF.begin(), fCDF.end(), u) - fCDF.begin();
+  const Instance& instance = fInstances[std::min(index, fInstances.size()-1)];
+
+  // uniform point in the solid: direct for boxes, rejection in the bounding box otherwise
+  G4ThreeVector point;
+  do {
+    point.set(CLHEP::RandFlat::shoot(&fEngine, instance.boxMin.x(), instance.boxMax.x()),
+              CLHEP::RandFlat::shoot(&fEngine, instance.boxMin.y(), instance.boxMax.y()),
+              CLHEP::RandFlat::shoot(&fEngine, instance.boxMin.z(), instance.boxMax.z()));
+  } while (!instance.isBox && instance.solid->Inside(point) != kInside);
+
+  return instance.toGlobal.TransformPoint(point);
+}
@@ -0,0 +1,114 @@
+#include "reco/HitIndex.hh"
+
+#include <algorithm>
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HitIndex::Clear()
+{
+  fLayer.clear();
+  fRow.clear();
+  fCol.clear();
+  fBuckets.clear();
+  fLayers.clear();
+  fModules.clear();
+  fSorted.clear();
+}
+
+void HitIndex::AddHit(int layer, int row, int col)
+{
+  fLayer.push_back(layer);
+  fRow.push_back(row);
+  fCol.push_back(col);
+}
+
+void HitIndex::Build(const PixelHitsCollection& hits)
+{
+  Clear();
+  for (std::size_t i = 0; i < hits.entries(); ++i) AddHit(hits[i]->GetLayerID(), hits[i]->GetRowID(), hits[i]->GetColID());
+  Build();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HitIndex::Build()
+{
+  const std::size_t nHits = fLayer.size();
+  fBuckets.clear();
+  fLayers.clear();
+  fModules.clear();
+
+  // count the hits per bucket, layer and module
+  fHitBucket.resize(nHits);
+  for (std::size_t i = 0; i < nHits; ++i) {
+    const int br = FloorDiv(fRow[i], fBucketSize);
+    const int bc = FloorDiv(fCol[i], fBucketSize);
+    fHitBucket[i] = Key(fLayer[i], br, bc);
+    fBuckets[fHitBucket[i]].n++;
+
+    LayerBounds& bounds = fLayers[fLayer[i]];
+    if (bounds.count++ == 0) {
+      bounds.rowMin = bounds.rowMax = br;
+      bounds.colMin = bounds.colMax = bc;
+    }
+    else {
+      bounds.rowMin = std::min(bounds.rowMin, br);
+      bounds.rowMax = std::max(bounds.rowMax, br);
+      bounds.colMin = std::min(bounds.colMin, bc);
+      bounds.colMax = std::max(bounds.colMax, bc);
+    }
+
+    if (fModuleRows > 0 && fModuleCols > 0)
+      fModules[Key(fLayer[i], FloorDiv(fRow[i], fModuleRows), FloorDiv(fCol[i], fModuleCols))]++;
+  }
+
+  // bucket offsets, then place the hits
+  std::uint32_t offset = 0;
+  for (auto& [key, bucket] : fBuckets) {
+    bucket.first = offset;
+    offset += bucket.n;
+    bucket.n = 0;
+  }
+  fSorted.resize(nHits);
+  for (std::size_t i = 0; i < nHits; ++i) {
+    Bucket& bucket = fBuckets[fHitBucket[i]];
+    fSorted[bucket.first + bucket.n++] = static_cast<int>(i);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void HitIndex::InRange(int layer, int row, int col, int radius, std::vector<int>& hits) const
+{
+  hits.clear();
+  ForEachInRange(layer, row, col, radius, [&](int hit) { hits.push_back(hit); });
+}
+
+std::size_t HitIndex::CountInRange(int layer, int row, int col, int radius) const
+{
+  std::size_t n = 0;
+  ForEachInRange(layer, row, col, radius, [&](int) { ++n; });
+  return n;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int HitIndex::Nearest(int layer, double row, double col, double maxDistance) const
+{
+  return Nearest(layer, row, col, maxDistance, [](int) { return true; });
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int HitIndex::LayerCount(int layer) const
+{
+  auto it = fLayers.find(layer);
+  return it == fLayers.end() ? 0 : it->second.count;
+}
+
+int HitIndex::ModuleCount(int layer, int moduleRow, int moduleCol) const
+{
+  auto it = fModules.find(Key(layer, moduleRow, moduleCol));
+  return it == fModules.end() ? 0 : it->second;
+}
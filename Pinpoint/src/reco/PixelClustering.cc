@@ -0,0 +1,124 @@
+#include "reco/PixelClustering.hh"
+
+#include <algorithm>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void PixelClustering::Clear()
+{
+  fLayer.clear();
+  fRow.clear();
+  fCol.clear();
+  fWeight.clear();
+  fClusters.clear();
+  fHitCluster.clear();
+}
+
+void PixelClustering::AddHit(int layer, int row, int col, double weight)
+{
+  fLayer.push_back(layer);
+  fRow.push_back(row);
+  fCol.push_back(col);
+  fWeight.push_back(weight);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int PixelClustering::Find(int i)
+{
+  // path halving
+  while (fParent[i] != i) {
+    fParent[i] = fParent[fParent[i]];
+    i = fParent[i];
+  }
+  return i;
+}
+
+void PixelClustering::Union(int a, int b)
+{
+  a = Find(a);
+  b = Find(b);
+  // the root is the first pixel of the cluster, which keeps the cluster order stable
+  if (a < b) fParent[b] = a;
+  else if (b < a) fParent[a] = b;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const std::vector<PixelClustering::Cluster>& PixelClustering::Run()
+{
+  const std::size_t nHits = fLayer.size();
+  fClusters.clear();
+
+  // sort by channel and merge hits on the same pixel
+  fOrder.resize(nHits);
+  for (std::size_t i = 0; i < nHits; i++) fOrder[i] = {Key(fLayer[i], fRow[i], fCol[i]), static_cast<int>(i)};
+  std::sort(fOrder.begin(), fOrder.end());
+
+  fPixelKey.clear();
+  fHitPixel.resize(nHits);
+  for (const auto& [key, hit] : fOrder) {
+    if (fPixelKey.empty() || fPixelKey.back() != key) fPixelKey.push_back(key);
+    fHitPixel[hit] = static_cast<int>(fPixelKey.size()) - 1;
+  }
+  const int nPixels = static_cast<int>(fPixelKey.size());
+
+  // join every pixel with its neighbours further in the sort order: the next
+  // column of the same row, and the next row (columns -1..+1 with 8-connectivity)
+  fParent.resize(nPixels);
+  for (int i = 0; i < nPixels; i++) fParent[i] = i;
+  for (int i = 0; i < nPixels; i++) {
+    const std::uint64_t key = fPixelKey[i];
+    if (i + 1 < nPixels && fPixelKey[i + 1] == key + 1) Union(i, i + 1);
+
+    const int col = PixelGeometry::KeyCol(key);
+    const std::uint64_t below = key + (std::uint64_t(1) << PixelGeometry::kKeyBits);
+    const std::uint64_t first = (fDiagonal && col > 0) ? below - 1 : below;
+    const std::uint64_t last = fDiagonal ? below + 1 : below;
+    auto it = std::lower_bound(fPixelKey.begin() + i + 1, fPixelKey.end(), first);
+    for (; it != fPixelKey.end() && *it <= last; ++it) Union(i, static_cast<int>(it - fPixelKey.begin()));
+  }
+
+  // roots are the first pixel of their cluster, so clusters are numbered in key order
+  fPixelCluster.assign(nPixels, -1);
+  for (int i = 0; i < nPixels; i++) {
+    int root = Find(i);
+    if (fPixelCluster[root] < 0) {
+      fPixelCluster[root] = static_cast<int>(fClusters.size());
+      Cluster cluster;
+      cluster.layer = PixelGeometry::KeyLayer(fPixelKey[i]);
+      cluster.rowMin = cluster.rowMax = PixelGeometry::KeyRow(fPixelKey[i]);
+      cluster.colMin = cluster.colMax = PixelGeometry::KeyCol(fPixelKey[i]);
+      fClusters.push_back(cluster);
+    }
+    fPixelCluster[i] = fPixelCluster[root];
+    Cluster& cluster = fClusters[fPixelCluster[i]];
+    const int row = PixelGeometry::KeyRow(fPixelKey[i]);
+    const int col = PixelGeometry::KeyCol(fPixelKey[i]);
+    cluster.size++;
+    cluster.rowMin = std::min(cluster.rowMin, row);
+    cluster.rowMax = std::max(cluster.rowMax, row);
+    cluster.colMin = std::min(cluster.colMin, col);
+    cluster.colMax = std::max(cluster.colMax, col);
+  }
+
+  fHitCluster.resize(nHits);
+  for (std::size_t i = 0; i < nHits; i++) {
+    Cluster& cluster = fClusters[fPixelCluster[fHitPixel[i]]];
+    fHitCluster[i] = fPixelCluster[fHitPixel[i]];
+    cluster.weight += fWeight[i];
+    cluster.row += fWeight[i] * fRow[i];
+    cluster.col += fWeight[i] * fCol[i];
+  }
+  for (auto& cluster : fClusters) {
+    if (cluster.weight > 0.) {
+      cluster.row /= cluster.weight;
+      cluster.col /= cluster.weight;
+    }
+    else {
+      cluster.row = 0.5 * (cluster.rowMin + cluster.rowMax);
+      cluster.col = 0.5 * (cluster.colMin + cluster.colMax);
+    }
+  }
+  return fClusters;
+}
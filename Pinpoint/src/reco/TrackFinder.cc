@@ -0,0 +1,135 @@
+#include "reco/TrackFinder.hh"
+
+#include <algorithm>
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int TrackFinder::Follow(const HitIndex& index, const PixelGeometry& geometry, const LineFit& fit, int layer) const
+{
+  double x0, tx, y0, ty;
+  fit.Solve(x0, tx, y0, ty);
+  const double z = geometry.Z(layer);
+  // continuous pixel coordinates of the prediction
+  const double row = (x0 + tx * z - geometry.X(0)) / geometry.GetPitchX();
+  const double col = (y0 + ty * z - geometry.Y(0)) / geometry.GetPitchY();
+  const double tolerance = fTolerance / std::min(geometry.GetPitchX(), geometry.GetPitchY());
+  // hits of accepted tracks are not shared
+  return index.Nearest(layer, row, col, tolerance, [this](int hit) { return !fUsed[hit]; });
+}
+
+bool TrackFinder::IsIsolated(const HitIndex& index, int hit)
+{
+  if (fIsolated[hit] == 0) {
+    const std::size_t n = index.CountInRange(index.GetLayer(hit), index.GetRow(hit), index.GetCol(hit), fIsolation);
+    fIsolated[hit] = static_cast<int>(n) <= fMaxNeighbours ? 1 : 2;
+  }
+  return fIsolated[hit] == 1;
+}
+
+void TrackFinder::Extend(const HitIndex& index, const PixelGeometry& geometry, LineFit& fit, int start, int step)
+{
+  int missing = 0;
+  for (int layer = start; layer >= 0 && layer < geometry.GetNLayers() && missing <= fMaxMissing; layer += step) {
+    const int hit = fLayerHits[layer] > 0 ? Follow(index, geometry, fit, layer) : -1;
+    if (hit < 0) {
+      missing++;
+      continue;
+    }
+    missing = 0;
+    fit.Add(fZ[hit], fX[hit], fY[hit]);
+    fCandidate.push_back(hit);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const std::vector<TrackFinder::Track>& TrackFinder::Find(const HitIndex& index, const PixelGeometry& geometry)
+{
+  fTracks.clear();
+  const int nHits = static_cast<int>(index.size());
+  const int nLayers = geometry.GetNLayers();
+
+  // positions, and hits grouped by layer
+  fX.resize(nHits);
+  fY.resize(nHits);
+  fZ.resize(nHits);
+  fUsed.assign(nHits, 0);
+  fIsolated.assign(nHits, 0);
+  fLayerFirst.assign(nLayers + 1, 0);
+  fLayerHits.assign(nLayers, 0);
+  for (int i = 0; i < nHits; ++i) {
+    fX[i] = geometry.X(index.GetRow(i));
+    fY[i] = geometry.Y(index.GetCol(i));
+    fZ[i] = geometry.Z(index.GetLayer(i));
+    if (index.GetLayer(i) >= 0 && index.GetLayer(i) < nLayers) fLayerHits[index.GetLayer(i)]++;
+  }
+  for (int layer = 0; layer < nLayers; ++layer) fLayerFirst[layer + 1] = fLayerFirst[layer] + fLayerHits[layer];
+  std::vector<int> byLayer(fLayerFirst[nLayers]);
+  {
+    std::vector<int> next(fLayerFirst.begin(), fLayerFirst.end() - 1);
+    for (int i = 0; i < nHits; ++i) {
+      const int layer = index.GetLayer(i);
+      if (layer >= 0 && layer < nLayers) byLayer[next[layer]++] = i;
+    }
+  }
+
+  // seed window in the next layer, in pixels
+  const double dz = geometry.GetLayerPitch();
+  const double slack = fTolerance / std::min(geometry.GetPitchX(), geometry.GetPitchY());
+  const int window = static_cast<int>(std::ceil(fMaxSlope * dz / std::min(geometry.GetPitchX(), geometry.GetPitchY()) + slack));
+
+  int nSeeds = 0;
+  for (int layer = 0; layer + 1 < nLayers && (int)fTracks.size() < fMaxTracks && nSeeds < fMaxSeeds; ++layer) {
+    for (int k = fLayerFirst[layer]; k < fLayerFirst[layer + 1] && (int)fTracks.size() < fMaxTracks; ++k) {
+      const int a = byLayer[k];
+      if (fUsed[a] || fLayerHits[layer + 1] == 0 || !IsIsolated(index, a)) continue;
+
+      fPartners.clear();
+      index.ForEachInRange(layer + 1, index.GetRow(a), index.GetCol(a), window, [&](int b) {
+        if (!fUsed[b] && IsIsolated(index, b) && std::abs(fX[b] - fX[a]) <= fMaxSlope * dz + fTolerance &&
+            std::abs(fY[b] - fY[a]) <= fMaxSlope * dz + fTolerance) fPartners.push_back(b);
+      });
+
+      for (int b : fPartners) {
+        if (fUsed[a] || nSeeds++ >= fMaxSeeds) break;
+        LineFit seed;
+        seed.Add(fZ[a], fX[a], fY[a]);
+        seed.Add(fZ[b], fX[b], fY[b]);
+
+        // confirmation in one of the next two layers
+        int confirmation = -1;
+        for (int next = layer + 2; next <= layer + 3 && next < nLayers && confirmation < 0; ++next)
+          if (fLayerHits[next] > 0) confirmation = Follow(index, geometry, seed, next);
+        if (confirmation < 0) continue;
+
+        LineFit fit = seed;
+        fCandidate.assign({a, b});
+        Extend(index, geometry, fit, layer + 2, +1);
+        Extend(index, geometry, fit, layer - 1, -1);
+        if ((int)fCandidate.size() < fMinHits) continue;
+
+        Track track;
+        fit.Solve(track.x0, track.tx, track.y0, track.ty);
+        const double sigmaX2 = geometry.GetPitchX() * geometry.GetPitchX() / 12.;
+        const double sigmaY2 = geometry.GetPitchY() * geometry.GetPitchY() / 12.;
+        for (int hit : fCandidate) {
+          const double rx = fX[hit] - track.x0 - track.tx * fZ[hit];
+          const double ry = fY[hit] - track.y0 - track.ty * fZ[hit];
+          track.chi2 += rx * rx / sigmaX2 + ry * ry / sigmaY2;
+        }
+        track.ndf = 2 * static_cast<int>(fCandidate.size()) - 4;
+        if (track.chi2 > fMaxChi2 * track.ndf) continue;
+        for (int hit : fCandidate) fUsed[hit] = 1;
+        std::sort(fCandidate.begin(), fCandidate.end(),
+                  [&](int l, int r) { return index.GetLayer(l) < index.GetLayer(r); });
+        track.firstLayer = index.GetLayer(fCandidate.front());
+        track.lastLayer = index.GetLayer(fCandidate.back());
+        track.hits = fCandidate;
+        fTracks.push_back(std::move(track));
+        break;
+      }
+    }
+  }
+  return fTracks;
+}
@@ -0,0 +1,110 @@
+"""
+Benchmark the start-up time of the GEANT4 app
+----------------------------------------------------------------------------
+Our production jobs are short, so the time spent before the first event is
+simulated is a large fraction of their cost. This script runs the app a few
+times with a single event and reports the wall-clock time from process start
+to each `[startup]` mark printed by the app (application constructed, run
+initialised, first event), plus the total time of the process.
+Script takes the following arguements:
+1) g4exe - path to the GEANT4 app executable file
+2) --repeat - number of runs to average over (default 5)
+3) --events - number of events per run (default 1)
+4) any further arguments are passed on to the app, e.g. --generator hepmc --input f.hepmc
+Results can be appended to a csv file with --csv to track them over time.
+"""
+
+import argparse
+import csv
+import datetime
+import os
+import re
+import statistics
+import subprocess
+import sys
+import tempfile
+import time
+
+MARK = re.compile(r"^\[startup\] (.+): ([0-9.eE+-]+) s$")
+
+
+def run_once(g4exe: str, events: int, extra_args: list) -> dict:
+    """
+    Runs the app once and collects the start-up marks
+
+    Args:
+        g4exe (str): filepath to geant4 app executable file
+        events (int): number of events to run
+        extra_args (list): additional command line arguments for the app
+    Returns:
+        dict: phase -> seconds since process start, with the total time under "process exit"
+    """
+    with tempfile.TemporaryDirectory() as tmpdir:
+        command = [g4exe, "--events", str(events), "--output", os.path.join(tmpdir, "startup.root")] + extra_args
+
+        start = time.perf_counter()
+        result = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT, text=True,
+                                cwd=os.path.dirname(g4exe))
+        total = time.perf_counter() - start
+
+    if result.returncode != 0:
+        sys.exit(f"{' '.join(command)} failed:\n{result.stdout[-2000:]}")
+
+    marks = {}
+    for line in result.stdout.splitlines():
+        match = MARK.match(line.strip())
+        if match:
+            marks[match.group(1)] = float(match.group(2))
+    marks["process exit"] = total
+    return marks
+
+
+def main(g4exe: str, repeat: int, events: int, extra_args: list, csv_file: str) -> None:
+    """
+    Main code body
+
+    Args:
+        g4exe (str): filepath to geant4 app executable file
+        repeat (int): number of runs
+        events (int): number of events per run
+        extra_args (list): additional command line arguments for the app
+        csv_file (str): if set, append the median of each phase to this file
+    Returns:
+        None
+    """
+    runs = [run_once(g4exe, events, extra_args) for _ in range(repeat)]
+
+    phases = []
+    for marks in runs:
+        for phase in marks:
+            if phase not in phases:
+                phases.append(phase)
+
+    print(f"{'phase':<28}{'median [s]':>12}{'min [s]':>12}{'max [s]':>12}")
+    medians = {}
+    for phase in phases:
+        values = [marks[phase] for marks in runs if phase in marks]
+        medians[phase] = statistics.median(values)
+        print(f"{phase:<28}{medians[phase]:>12.3f}{min(values):>12.3f}{max(values):>12.3f}")
+
+    if csv_file:
+        new_file = not os.path.exists(csv_file)
+        with open(csv_file, "a", newline="") as f:
+            writer = csv.writer(f)
+            if new_file:
+                writer.writerow(["date", "args", "repeat"] + phases)
+            writer.writerow([datetime.datetime.now().isoformat(timespec="seconds"), " ".join(extra_args), repeat]
+                            + [f"{medians[phase]:.4f}" for phase in phases])
+
+
+if __name__ == "__main__":
+
+    parser = argparse.ArgumentParser()
+    parser.add_argument("g4exe", help='path to geant4 app executable')
+    parser.add_argument("--repeat", type=int, default=5, help='number of runs')
+    parser.add_argument("--events", type=int, default=1, help='events per run')
+    parser.add_argument("--csv", default=None, help='append the results to this csv file')
+
+    args, extra_args = parser.parse_known_args()
+
+    main(os.path.abspath(args.g4exe), args.repeat, args.events, extra_args, args.csv)
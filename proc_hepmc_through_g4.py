@@ -49,28 +49,23 @@ def get_number_of_events_in_hepmc(hepmc_file: str) -> int:
     return event_count
 
 
-def write_macro(hepmcfile: str, outputfile: str, nevents: int=1000, macro_name: str="proc_hepmc.in", gui: str=False) -> None:
+def pinpoint_command(g4exe: str, hepmcfile: str, outputfile: str, nevents: int=1000, seed: int=None) -> str:
     """
-    Function to write geant4 steering macro
-    
+    Function to build the command line running one hepmc file through geant4
+
     Args:
+        g4exe (str): filepath to geant4 app executable file
         hepmcfile (str): filepath to hepmc to process
         outputfile (str): filepath to where NTuple output will be saved
         nevents (int, optional): Number of HEPMC evets to run over. Defaults to 1000.
-        macro_name (str, optional): file name of macro. Defaults to "proc_hepmc.in".
-        gui (str, optional): if True, will create GUI (probably unhelpful but left in just in case). Defaults to False.
+        seed (int, optional): master seed of the run, the application default is used if None. Defaults to None.
     Returns:
-        None
+        str: the command
     """
-    file_contents = f"\
-{'/control/execute vis.mac' if gui else ''}\n\
-/generator/select hepmcAscii\n\
-/generator/hepmcAscii/open {hepmcfile}\n\
-/ntuple/output {outputfile}\n\
-/run/beamOn {nevents}"
-    
-    with open(macro_name, 'w') as macro:
-        macro.write(file_contents)
+    command = f"{g4exe} --generator hepmc --input {hepmcfile} --output {outputfile} --events {nevents}"
+    if seed is not None:
+        command += f" --seed {seed}"
+    return command
 
 
 def process_one_file(g4exe: str, input_file: str, output_dir: str, nevents: int, output_queue: multiprocessing.Queue) -> None:
@@ -87,11 +82,9 @@ def process_one_file(g4exe: str, input_file: str, output_dir: str, nevents: int,
     Returns:
         None
     """
-    macro_name = os.path.basename(input_file).replace(".hepmc", ".in")
     new_output_filepath = os.path.join(output_dir, os.path.basename(input_file).replace(".hepmc", ".root"))
     logfile_name = os.path.join("logs", os.path.basename(input_file).replace(".hepmc", ".log"))
     
-    write_macro(input_file, new_output_filepath, nevents=nevents, macro_name=macro_name)
     print(f"Processesing {input_file}...")
     
     # Check if output file exists and is a valid ROOT file
@@ -108,9 +101,9 @@ def process_one_file(g4exe: str, input_file: str, output_dir: str, nevents: int,
     if skip_file:
         return
     
-    os.system(f"./{os.path.basename(g4exe)} {macro_name} > {logfile_name} 2>&1")
+    status = os.system(f"{pinpoint_command(g4exe, input_file, new_output_filepath, nevents=nevents)} > {logfile_name} 2>&1")
 
-    if os.path.exists(new_output_filepath):
+    if status == 0 and os.path.exists(new_output_filepath):
         output_queue.put((input_file, True))
     else:
         output_queue.put((input_file, False))